@@ -0,0 +1,68 @@
+/**
+ * Compares analysing the whole source again after every keystroke with the incremental analysis of the edit.
+ * Build with -DCMAKE_BUILD_TYPE=Release, usage: incremental_analysis_benchmark [statements] [keystrokes]
+ * @file: incremental_analysis_benchmark.cpp
+ * @date: 17.10.2026
+ */
+
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <sstream>
+#include <string>
+
+#include "../src/compilation_context.h"
+#include "../src/lexical_analysis.h"
+#include "../src/syntax_analysis.h"
+#include "../src/semantic_analysis.h"
+#include "../src/incremental_analysis.h"
+
+int main(int argc, char **argv) {
+    size_t statements = argc > 1 ? std::stoul(argv[1]) : 20000;
+    int keystrokes = argc > 2 ? std::stoi(argv[2]) : 100;
+
+    std::ostringstream source;
+    source << "var v0 = 1;\n";
+    for (size_t i = 1; i < statements; i++) source << "var v" << i << " = v" << i - 1 << " * 2 - v0;\n";
+
+    printf("Statements: %zu, keystrokes: %d\n", statements, keystrokes);
+
+    // Every keystroke types a digit into a literal in the middle of the source and deletes it again
+    IncrementalAnalysis analysis(source.str());
+    size_t offset = analysis.get_text().find("* 2", analysis.get_text().size() / 2) + 3;
+    size_t errors = 0;
+
+    std::string text = analysis.get_text();
+    auto start = std::chrono::steady_clock::now();
+    for (int i = 0; i < keystrokes; i++) {
+        if (i % 2 == 0) text.insert(offset, "1");
+        else
+            text.erase(offset, 1);
+
+        std::istringstream stream(text);
+        CompilationContext context(SIZE_MAX);
+        LexicalAnalysis lexical_analysis(&stream);
+        SyntaxAnalysis syntax_analysis(&lexical_analysis, &context);
+        SemanticAnalysis semantic_analysis(&context);
+        semantic_analysis.analyze_tree(syntax_analysis.build_tree());
+        errors += context.get_diagnostics()->size();
+    }
+    auto end = std::chrono::steady_clock::now();
+    double full = std::chrono::duration<double, std::milli>(end - start).count() / keystrokes;
+
+    start = std::chrono::steady_clock::now();
+    for (int i = 0; i < keystrokes; i++) {
+        if (i % 2 == 0) analysis.apply_edit(offset, 0, "1");
+        else
+            analysis.apply_edit(offset, 1, "");
+
+        errors += analysis.get_diagnostics().size();
+    }
+    end = std::chrono::steady_clock::now();
+    double incremental = std::chrono::duration<double, std::milli>(end - start).count() / keystrokes;
+
+    printf("full: %10.3f ms   incremental: %8.3f ms   speedup: %7.1fx   (%zu errors)\n", full, incremental,
+           full / incremental, errors);
+
+    return 0;
+}
@@ -0,0 +1,95 @@
+/**
+ * Compares the scalar and vectorised character run scanners.
+ * Build with -DCMAKE_BUILD_TYPE=Release, usage: lexer_scan_benchmark [statements] [iterations]
+ * @file: lexer_scan_benchmark.cpp
+ * @date: 17.10.2026
+ */
+
+#include <chrono>
+#include <cstdio>
+#include <initializer_list>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include "../src/lexical_analysis.h"
+#include "../src/util/character_class.h"
+
+static const char *scanner_names[] = {"scalar", "sse2", "avx2"};
+
+/**
+ * Machine generated looking source: deep indentation and long identifiers
+ */
+static std::string generate_source(size_t statements) {
+    std::ostringstream source;
+
+    for (size_t i = 0; i < statements; i++) {
+        source << std::string(4 + (i % 8) * 4, ' ') << "var generated_variable_name_" << i
+               << " = 1234567890 * generated_variable_name_" << (i == 0 ? 0 : i - 1) << " + 3.25e10;\n";
+    }
+
+    return source.str();
+}
+
+template<typename F>
+static double measure(int iterations, F &&function) {
+    auto start = std::chrono::steady_clock::now();
+    for (int i = 0; i < iterations; i++) function();
+    auto end = std::chrono::steady_clock::now();
+
+    return std::chrono::duration<double, std::milli>(end - start).count() / iterations;
+}
+
+int main(int argc, char **argv) {
+    size_t statements = argc > 1 ? std::stoul(argv[1]) : 100000;
+    int iterations = argc > 2 ? std::stoi(argv[2]) : 10;
+
+    std::string source = generate_source(statements);
+    printf("Source: %zu bytes, %zu statements, %d iterations\n", source.size(), statements, iterations);
+
+    std::vector<size_t> whitespace_runs, identifier_runs;
+    for (size_t i = 0; i < source.size(); i++) {
+        bool run_start = i == 0 || is_whitespace(source[i]) != is_whitespace(source[i - 1]) ||
+                         is_identifier(source[i]) != is_identifier(source[i - 1]);
+        if (!run_start) continue;
+
+        if (is_whitespace(source[i])) whitespace_runs.push_back(i);
+        if (is_identifier(source[i])) identifier_runs.push_back(i);
+    }
+
+    for (auto kind: {CHAR_SCANNER_SCALAR, CHAR_SCANNER_SSE2, CHAR_SCANNER_AVX2}) {
+        auto scanner = CharacterScanner::get(kind);
+        if (scanner == nullptr) {
+            printf("%-8s not supported\n", scanner_names[kind]);
+            continue;
+        }
+
+        size_t token_count = 0;
+        double lexing = measure(iterations, [&]() {
+            SourceBuffer buffer(source.data(), source.size());
+            LexicalAnalysis analysis(&buffer);
+            analysis.set_scanner(scanner);
+            token_count = analysis.tokenize().size();
+        });
+
+        size_t skipped = 0;
+        double whitespace = measure(iterations, [&]() {
+            for (auto start: whitespace_runs) {
+                uint32_t line = 1;
+                size_t line_start = 0;
+                skipped += scanner->skip_whitespace(source.data(), start, source.size(), &line, &line_start);
+            }
+        });
+
+        double identifiers = measure(iterations, [&]() {
+            for (auto start: identifier_runs) skipped += scanner->skip_identifier(source.data(), start, source.size());
+        });
+
+        printf("%-8s tokenize: %8.3f ms (%zu tokens, %6.1f MB/s)   whitespace runs: %7.3f ms   identifier runs: "
+               "%7.3f ms\n",
+               scanner_names[kind], lexing, token_count, (double) source.size() / 1e3 / lexing, whitespace, identifiers);
+        (void) skipped;
+    }
+
+    return 0;
+}
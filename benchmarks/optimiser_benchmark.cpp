@@ -0,0 +1,96 @@
+/**
+ * Compares the single pass value propagation of the optimiser with the rescanning propagation it replaced.
+ * Build with -DCMAKE_BUILD_TYPE=Release, usage: optimiser_benchmark [statements] [iterations]
+ * @file: optimiser_benchmark.cpp
+ * @date: 17.10.2026
+ */
+
+#include <chrono>
+#include <cstdio>
+#include <sstream>
+#include <string>
+
+#include "../src/compilation_context.h"
+#include "../src/lexical_analysis.h"
+#include "../src/syntax_analysis.h"
+#include "../src/semantic_analysis.h"
+#include "../src/optimiser.h"
+
+/**
+ * The previous propagation, reduced to top level assignments. Every assignment scans the statements after it up to
+ * the next assignment of the same variable.
+ */
+static void rescanning_optimize(Optimiser &optimiser, SyntaxTree *root) {
+    for (uint32_t i = 0; i < root->statement_count; i++) {
+        SyntaxTree *assignment = root->statements[i];
+        if (assignment->type != SYN_NODE_ASSIGNMENT) continue;
+
+        assignment->right->process_tree_using([&](SyntaxTree *tree) { optimiser.calculate_expression(tree); },
+                                              POSTORDER);
+
+        SymbolSlot slot = assignment->left->slot;
+        for (uint32_t j = i + 1; j < root->statement_count; j++) {
+            SyntaxTree *statement = root->statements[j];
+            if (statement->type != SYN_NODE_ASSIGNMENT) continue;
+
+            statement->right->process_tree_using(
+                    [&](SyntaxTree *tree) {
+                        if (tree->type == SYN_NODE_IDENTIFIER && tree->slot == slot) {
+                            tree->type = assignment->right->type;
+                            tree->integer_value = assignment->right->integer_value;
+                        }
+                    },
+                    INORDER);
+
+            if (statement->left->slot == slot) break;
+        }
+    }
+}
+
+/**
+ * @return milliseconds spent in the function, averaged over the iterations. Every iteration optimises a fresh tree.
+ */
+template<typename F>
+static double measure(const std::string &source, int iterations, F &&function) {
+    double total = 0;
+
+    for (int i = 0; i < iterations; i++) {
+        std::istringstream stream(source);
+        CompilationContext context;
+        LexicalAnalysis lexical_analysis(&stream);
+        SyntaxAnalysis syntax_analysis(&lexical_analysis, &context);
+        SemanticAnalysis semantic_analysis(&context);
+        semantic_analysis.analyze_tree(syntax_analysis.build_tree());
+        Optimiser optimiser(&context);
+
+        auto start = std::chrono::steady_clock::now();
+        function(optimiser, context.get_syntax_tree());
+        auto end = std::chrono::steady_clock::now();
+
+        total += std::chrono::duration<double, std::milli>(end - start).count();
+    }
+
+    return total / iterations;
+}
+
+int main(int argc, char **argv) {
+    size_t statements = argc > 1 ? std::stoul(argv[1]) : 20000;
+    int iterations = argc > 2 ? std::stoi(argv[2]) : 3;
+
+    // Variables that are never reassigned make the previous propagation scan to the end of the program every time
+    std::ostringstream source;
+    source << "var v0 = 1;";
+    for (size_t i = 1; i < statements; i++) source << "var v" << i << " = v" << i - 1 << " * 2 - v0;";
+
+    printf("Statements: %zu, iterations: %d\n", statements, iterations);
+
+    double rescanning = measure(source.str(), iterations,
+                                [](Optimiser &optimiser, SyntaxTree *root) { rescanning_optimize(optimiser, root); });
+    double single_pass =
+            measure(source.str(), iterations, [](Optimiser &optimiser, SyntaxTree *) { optimiser.optimize(); });
+
+    printf("rescanning: %10.3f ms   single pass: %8.3f ms   speedup: %7.1fx\n", rescanning, single_pass,
+           rescanning / single_pass);
+
+    return 0;
+}
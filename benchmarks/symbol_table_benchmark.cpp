@@ -0,0 +1,119 @@
+/**
+ * Compares the hash symbol table with the unbalanced BST it replaced.
+ * Build with -DCMAKE_BUILD_TYPE=Release, usage: symbol_table_benchmark [names] [iterations]
+ * @file: symbol_table_benchmark.cpp
+ * @date: 17.10.2026
+ */
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "../src/symbol_table.h"
+
+/**
+ * The previous BST symbol table, reduced to insert and find. Iterative so that degenerate trees do not overflow
+ * the stack.
+ */
+class BstSymbolTable {
+private:
+    struct Node {
+        SymbolId key;
+        SymbolTableData *data;
+        Node *left;
+        Node *right;
+    };
+
+    Node *root = nullptr;
+
+    static void destroy(Node *node) {
+        while (node != nullptr) {
+            destroy(node->left);
+            Node *right = node->right;
+            delete node->data;
+            delete node;
+            node = right;
+        }
+    }
+
+public:
+    ~BstSymbolTable() { destroy(root); }
+
+    Node *find(SymbolId key) {
+        Node *node = root;
+        while (node != nullptr && node->key != key) node = key < node->key ? node->left : node->right;
+
+        return node;
+    }
+
+    Node *insert(SymbolId key) {
+        Node **link = &root;
+        while (*link != nullptr && (*link)->key != key) link = key < (*link)->key ? &(*link)->left : &(*link)->right;
+
+        if (*link == nullptr) *link = new Node{key, new SymbolTableData(), nullptr, nullptr};
+        return *link;
+    }
+};
+
+template<typename F>
+static double measure(int iterations, F &&function) {
+    auto start = std::chrono::steady_clock::now();
+    for (int i = 0; i < iterations; i++) function();
+    auto end = std::chrono::steady_clock::now();
+
+    return std::chrono::duration<double, std::milli>(end - start).count() / iterations;
+}
+
+template<typename Table>
+static size_t declare_and_use(const std::vector<SymbolId> &order) {
+    Table table;
+    size_t defined = 0;
+
+    for (auto key: order) table.insert(key)->data->set_flag(SYM_TABLE_IS_DEFINED);
+    for (auto key: order) defined += table.find(key) != nullptr;
+
+    return defined;
+}
+
+template<>
+size_t declare_and_use<SymbolTable>(const std::vector<SymbolId> &order) {
+    SymbolTable table;
+    size_t defined = 0;
+
+    for (auto key: order) table.insert(key)->data.set_flag(SYM_TABLE_IS_DEFINED);
+    for (auto key: order) defined += table.find(key) != nullptr;
+
+    return defined;
+}
+
+int main(int argc, char **argv) {
+    size_t count = argc > 1 ? std::stoul(argv[1]) : 20000;
+    int iterations = argc > 2 ? std::stoi(argv[2]) : 5;
+
+    // Generated code declares v0001, v0002, ... so the interner hands out ids in sorted name order
+    StringInterner interner;
+    std::vector<SymbolId> sorted;
+    for (size_t i = 0; i < count; i++) {
+        char name[32];
+        int length = snprintf(name, sizeof(name), "v%06zu", i);
+        sorted.push_back(interner.intern(name, (size_t) length));
+    }
+
+    std::vector<SymbolId> random = sorted;
+    std::shuffle(random.begin(), random.end(), std::mt19937(42));
+
+    printf("Names: %zu, iterations: %d\n", count, iterations);
+
+    size_t checksum = 0;
+    for (auto distribution: {std::make_pair("sorted", &sorted), std::make_pair("random", &random)}) {
+        double bst = measure(iterations, [&]() { checksum += declare_and_use<BstSymbolTable>(*distribution.second); });
+        double hash = measure(iterations, [&]() { checksum += declare_and_use<SymbolTable>(*distribution.second); });
+
+        printf("%-7s BST: %10.3f ms   hash: %8.3f ms   speedup: %7.1fx\n", distribution.first, bst, hash, bst / hash);
+    }
+
+    return checksum == 0;
+}
@@ -0,0 +1,77 @@
+/**
+ * Compares the iterative templated tree traversal with the recursive std::function visitor it replaced.
+ * Build with -DCMAKE_BUILD_TYPE=Release, usage: traversal_benchmark [statements] [iterations]
+ * @file: traversal_benchmark.cpp
+ * @date: 17.10.2026
+ */
+
+#include <chrono>
+#include <cstdio>
+#include <functional>
+#include <sstream>
+#include <string>
+
+#include "../src/compilation_context.h"
+#include "../src/syntax_analysis.h"
+
+/**
+ * The previous visitor, extended to statement lists the same way as the iterative one
+ */
+static void recursive_process_tree_using(SyntaxTree *tree, const std::function<void(SyntaxTree *)> &function,
+                                         TRAVERSAL_TYPE traversal_type) {
+    if (tree == nullptr) return;
+
+    if (tree->type & SYN_NODE_STATEMENT_LIST) {
+        if (traversal_type != POSTORDER) function(tree);
+        for (uint32_t i = 0; i < tree->statement_count; i++)
+            recursive_process_tree_using(tree->statements[i], function, traversal_type);
+        if (traversal_type == POSTORDER) function(tree);
+        return;
+    }
+
+    if (traversal_type == PREORDER) function(tree);
+    recursive_process_tree_using(tree->left, function, traversal_type);
+    if (traversal_type == INORDER) function(tree);
+    recursive_process_tree_using(tree->right, function, traversal_type);
+    if (traversal_type == POSTORDER) function(tree);
+}
+
+template<typename F>
+static double measure(int iterations, F &&function) {
+    auto start = std::chrono::steady_clock::now();
+    for (int i = 0; i < iterations; i++) function();
+    auto end = std::chrono::steady_clock::now();
+
+    return std::chrono::duration<double, std::milli>(end - start).count() / iterations;
+}
+
+int main(int argc, char **argv) {
+    size_t statements = argc > 1 ? std::stoul(argv[1]) : 20000;
+    int iterations = argc > 2 ? std::stoi(argv[2]) : 50;
+
+    std::ostringstream source;
+    source << "var v0 = 1;";
+    for (size_t i = 1; i < statements; i++) source << "var v" << i << " = (v" << i - 1 << " + 2) * 3 - v0 / 4;";
+
+    std::istringstream stream(source.str());
+    CompilationContext context;
+    LexicalAnalysis lexical_analysis(&stream);
+    SyntaxAnalysis syntax_analysis(&lexical_analysis, &context);
+    SyntaxTree *tree = syntax_analysis.build_tree();
+
+    printf("Statements: %zu, iterations: %d\n", statements, iterations);
+
+    size_t checksum = 0;
+    auto count_identifiers = [&checksum](SyntaxTree *node) { checksum += node->type == SYN_NODE_IDENTIFIER; };
+
+    for (auto order: {PREORDER, INORDER, POSTORDER}) {
+        double recursive =
+                measure(iterations, [&]() { recursive_process_tree_using(tree, count_identifiers, order); });
+        double iterative = measure(iterations, [&]() { tree->process_tree_using(count_identifiers, order); });
+
+        printf("order %d  recursive: %8.3f ms   iterative: %8.3f ms   speedup: %5.2fx\n", order, recursive, iterative,
+               recursive / iterative);
+    }
+
+    return checksum == 0;
+}
@@ -0,0 +1,64 @@
+/**
+ * Compares the cost of executing a program with the tree-walking evaluator and with the bytecode virtual machine.
+ * Programs have no inputs, so every run computes the same values again, the runs only repeat the same work until it
+ * takes long enough to measure. Build with -DCMAKE_BUILD_TYPE=Release, usage: vm_benchmark [statements] [runs]
+ * @file: vm_benchmark.cpp
+ * @date: 17.10.2026
+ */
+
+#include <chrono>
+#include <cstdio>
+#include <sstream>
+#include <string>
+
+#include "../src/compilation_pipeline.h"
+#include "../src/evaluator.h"
+#include "../src/bytecode.h"
+#include "../src/vm.h"
+
+/**
+ * @return milliseconds spent in all runs of the function
+ */
+template<typename F>
+static double measure(int runs, F &&function) {
+    auto start = std::chrono::steady_clock::now();
+    for (int i = 0; i < runs; i++) function();
+    auto end = std::chrono::steady_clock::now();
+
+    return std::chrono::duration<double, std::milli>(end - start).count();
+}
+
+int main(int argc, char **argv) {
+    size_t statements = argc > 1 ? std::stoul(argv[1]) : 1000;
+    int runs = argc > 2 ? std::stoi(argv[2]) : 2000;
+
+    // The program is not optimised, folding would leave nothing to run
+    std::ostringstream source;
+    source << "var v0 = 1; var f = 0.5;";
+    for (size_t i = 1; i < statements; i++) source << "var v" << i << " = v" << i - 1 << " * 3 - v0 + " << i << ";";
+    source << "f = f * v" << statements - 1 << " / 2 + f;";
+
+    CompilationPipeline pipeline;
+    pipeline.analyze(source.str());
+    BytecodeProgram program = pipeline.compile(pipeline.lower());
+
+    Evaluator evaluator(pipeline.get_context(), pipeline.get_slot_count());
+    VirtualMachine machine(&program);
+
+    printf("Statements: %zu, runs: %d, instructions: %zu, registers: %u\n", statements, runs,
+           program.instructions.size(), program.register_count);
+
+    double tree = measure(runs, [&]() { evaluator.run(); });
+    double switch_dispatch = measure(runs, [&]() { machine.run_switch(); });
+    double threaded = measure(runs, [&]() { machine.run(); });
+
+    if (evaluator.get_value(1).get_text() != machine.get_variable(1).get_text()) {
+        printf("Results differ\n");
+        return 1;
+    }
+
+    printf("tree: %10.3f ms   switch: %8.3f ms (%5.1fx)   threaded: %8.3f ms (%5.1fx)\n", tree, switch_dispatch,
+           tree / switch_dispatch, threaded, tree / threaded);
+
+    return 0;
+}
@@ -0,0 +1,215 @@
+/**
+ * Versioned binary artifact of a compiled program, executed straight from a mapped file
+ * @file: artifact.cpp
+ * @date: 17.10.2026
+ */
+
+#include <cstring>
+#include "artifact.h"
+#include "diagnostics.h"
+#include "syntax_analysis.h"
+#include "util/errors.h"
+#include "util/hash.h"
+
+void ArtifactWriter::add_symbol(const char *name, size_t length, SymbolSlot slot, SYM_TABLE_DATA_TYPE data_type,
+                                SYM_TABLE_NODE_FLAG flags) {
+    symbols.push_back({(uint32_t) names.size(), (uint32_t) length, slot, data_type, flags});
+    names.append(name, length);
+}
+
+void ArtifactWriter::add_declarations(SyntaxTree *root_tree) {
+    for (uint32_t i = 0; i < root_tree->statement_count; i++) {
+        SyntaxTree *statement = root_tree->statements[i];
+        if (statement->type != SYN_NODE_ASSIGNMENT || !(statement->attributes & SYN_TREE_ATTR_DECLARATION)) continue;
+
+        SyntaxTree *variable = statement->left;
+        SYM_TABLE_NODE_FLAG flags = SYM_TABLE_IS_DEFINED;
+        if (statement->attributes & SYN_TREE_ATTR_CONSTANT) flags |= SYM_TABLE_IS_CONSTANT;
+
+        add_symbol(variable->value, strlen(variable->value), variable->slot, variable->data_type, flags);
+    }
+}
+
+/**
+ * @return offset of the next section with the alignment of T
+ */
+template<typename T>
+static uint64_t align_section(std::string &data) {
+    data.resize((data.size() + alignof(T) - 1) / alignof(T) * alignof(T));
+
+    return data.size();
+}
+
+template<typename T>
+static void append_section(std::string &data, const T *items, size_t count) {
+    data.append((const char *) items, count * sizeof(T));
+}
+
+std::string ArtifactWriter::write(const BytecodeProgram &program) const {
+    ArtifactHeader header{};
+    header.magic = ARTIFACT_MAGIC;
+    header.version = ARTIFACT_VERSION;
+    header.variable_count = program.variable_count;
+    header.register_count = program.register_count;
+    header.constant_count = (uint32_t) program.constants.size();
+    header.instruction_count = (uint32_t) program.instructions.size();
+    header.symbol_count = (uint32_t) symbols.size();
+    header.names_size = (uint32_t) names.size();
+
+    // The machine keeps the type of the last store to a slot, which differs from the declared type after a
+    // reassignment such as an int by a float. Slots that are never stored to keep the declared type.
+    std::vector<ArtifactSymbol> final_symbols = symbols;
+    for (auto &symbol: final_symbols) {
+        if (symbol.slot < program.variable_types.size() &&
+            program.variable_types[symbol.slot] != SYM_TABLE_TYPE_UNKNOWN)
+            symbol.data_type = program.variable_types[symbol.slot];
+    }
+
+    std::string data(sizeof(ArtifactHeader), '\0');
+
+    header.constants_offset = align_section<BytecodeValue>(data);
+    append_section(data, program.constants.data(), program.constants.size());
+    header.types_offset = align_section<SYM_TABLE_DATA_TYPE>(data);
+    append_section(data, program.variable_types.data(), program.variable_types.size());
+    header.instructions_offset = align_section<BytecodeInstruction>(data);
+    append_section(data, program.instructions.data(), program.instructions.size());
+    header.symbols_offset = align_section<ArtifactSymbol>(data);
+    append_section(data, final_symbols.data(), final_symbols.size());
+    header.names_offset = data.size();
+    data += names;
+
+    header.size = data.size();
+    header.checksum = hash_bytes(data.data() + sizeof(ArtifactHeader), data.size() - sizeof(ArtifactHeader));
+    memcpy(&data[0], &header, sizeof(header));
+
+    return data;
+}
+
+Artifact::Artifact(SourceBuffer *buffer)
+    : buffer(buffer), header((const ArtifactHeader *) buffer->get_data()) {}
+
+/**
+ * @return whether count items of T at the offset lie inside the artifact and are aligned
+ */
+template<typename T>
+static bool section_fits(const ArtifactHeader *header, uint64_t offset, uint64_t count) {
+    return offset % alignof(T) == 0 && offset >= sizeof(ArtifactHeader) && offset <= header->size &&
+           count <= (header->size - offset) / sizeof(T);
+}
+
+bool Artifact::validate(const SourceBuffer *buffer, Diagnostics *diagnostics) {
+    const char *data = buffer->get_data();
+    auto header = (const ArtifactHeader *) data;
+
+    uint32_t magic = 0;
+    if (buffer->get_length() >= sizeof(ArtifactHeader)) memcpy(&magic, data, sizeof(magic));
+    if (magic != ARTIFACT_MAGIC) {
+        diagnostics->report(ARTIFACT_INVALID_ERROR_CODE, 0, 0, "Not a compiled artifact");
+        return false;
+    }
+
+    // A mapping starts at a page, a buffer read from a stream is allocated with the alignment of any scalar. Only a
+    // view into other memory can be misaligned, and the sections are used in place.
+    if ((uintptr_t) data % alignof(ArtifactHeader) != 0) {
+        diagnostics->report(ARTIFACT_ALIGNMENT_ERROR_CODE, 0, 0, "Artifact is not aligned to %zu bytes in memory",
+                            alignof(ArtifactHeader));
+        return false;
+    }
+
+    if (header->version != ARTIFACT_VERSION) {
+        diagnostics->report(ARTIFACT_VERSION_ERROR_CODE, 0, 0, "Artifact version %u, expected %u", header->version,
+                            ARTIFACT_VERSION);
+        return false;
+    }
+
+    if (header->size != buffer->get_length() ||
+        header->checksum !=
+                hash_bytes(data + sizeof(ArtifactHeader), buffer->get_length() - sizeof(ArtifactHeader))) {
+        diagnostics->report(ARTIFACT_CHECKSUM_ERROR_CODE, 0, 0, "Artifact checksum mismatch");
+        return false;
+    }
+
+    // Checked even behind a valid checksum, the machine trusts the registers of every instruction
+    bool is_valid = header->variable_count + (uint64_t) header->constant_count <= header->register_count &&
+                    section_fits<BytecodeValue>(header, header->constants_offset, header->constant_count) &&
+                    section_fits<SYM_TABLE_DATA_TYPE>(header, header->types_offset, header->variable_count) &&
+                    section_fits<BytecodeInstruction>(header, header->instructions_offset,
+                                                      header->instruction_count) &&
+                    section_fits<ArtifactSymbol>(header, header->symbols_offset, header->symbol_count) &&
+                    section_fits<char>(header, header->names_offset, header->names_size);
+
+    auto instructions = (const BytecodeInstruction *) (data + header->instructions_offset);
+    for (uint32_t i = 0; is_valid && i < header->instruction_count; i++) {
+        const BytecodeInstruction &instruction = instructions[i];
+
+        is_valid = instruction.get_opcode() == BC_OP_HALT ||
+                   (instruction.get_opcode() < BC_OP_COUNT && instruction.get_dest() < header->register_count &&
+                    instruction.operands[0] < header->register_count &&
+                    instruction.operands[1] < header->register_count);
+    }
+
+    if (is_valid && header->instruction_count > 0)
+        is_valid = instructions[header->instruction_count - 1].get_opcode() == BC_OP_HALT;
+
+    auto symbols = (const ArtifactSymbol *) (data + header->symbols_offset);
+    for (uint32_t i = 0; is_valid && i < header->symbol_count; i++) {
+        is_valid = symbols[i].slot < header->variable_count &&
+                   symbols[i].name_offset + (uint64_t) symbols[i].name_length <= header->names_size;
+    }
+
+    if (!is_valid) diagnostics->report(ARTIFACT_INVALID_ERROR_CODE, 0, 0, "Malformed artifact");
+
+    return is_valid;
+}
+
+Artifact *Artifact::from_buffer(SourceBuffer *buffer, Diagnostics *diagnostics) {
+    if (!validate(buffer, diagnostics)) {
+        delete buffer;
+        return nullptr;
+    }
+
+    return new Artifact(buffer);
+}
+
+Artifact *Artifact::load(const char *path, Diagnostics *diagnostics) {
+    SourceBuffer *buffer = SourceBuffer::map_file(path);
+    if (buffer == nullptr) {
+        diagnostics->report(DRIVER_OPEN_FILE_ERROR_CODE, 0, 0, "Cannot open file %s", path);
+        return nullptr;
+    }
+
+    return from_buffer(buffer, diagnostics);
+}
+
+BytecodeView Artifact::get_program() const {
+    const char *data = buffer->get_data();
+
+    return {(const BytecodeInstruction *) (data + header->instructions_offset),
+            header->instruction_count,
+            (const BytecodeValue *) (data + header->constants_offset),
+            header->constant_count,
+            header->variable_count,
+            header->register_count,
+            (const SYM_TABLE_DATA_TYPE *) (data + header->types_offset)};
+}
+
+uint32_t Artifact::get_symbol_count() const { return header->symbol_count; }
+
+const ArtifactSymbol &Artifact::get_symbol(uint32_t index) const {
+    return ((const ArtifactSymbol *) (buffer->get_data() + header->symbols_offset))[index];
+}
+
+std::string Artifact::get_name(const ArtifactSymbol &symbol) const {
+    return std::string(buffer->get_data() + header->names_offset + symbol.name_offset, symbol.name_length);
+}
+
+const ArtifactSymbol *Artifact::find_symbol(const char *name, size_t length) const {
+    const char *names = buffer->get_data() + header->names_offset;
+
+    for (uint32_t i = 0; i < header->symbol_count; i++) {
+        const ArtifactSymbol &symbol = get_symbol(i);
+        if (symbol.name_length == length && memcmp(names + symbol.name_offset, name, length) == 0) return &symbol;
+    }
+
+    return nullptr;
+}
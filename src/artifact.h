@@ -0,0 +1,143 @@
+/**
+ * Versioned binary artifact of a compiled program, executed straight from a mapped file
+ * @file: artifact.h
+ * @date: 17.10.2026
+ */
+
+#ifndef SOMA_COMPILER_ARTIFACT_H
+#define SOMA_COMPILER_ARTIFACT_H
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+#include "bytecode.h"
+#include "source_buffer.h"
+#include "symbol_table.h"
+#include "util/types.h"
+
+class SyntaxTree;
+
+class Diagnostics;
+
+// "SOMA" read as a little-endian word, a reader of the other byte order sees another magic
+#define ARTIFACT_MAGIC 0x414d4f53u
+
+// Raised whenever the layout or the meaning of the bytecode changes, older artifacts are rejected
+#define ARTIFACT_VERSION 2
+
+#define ARTIFACT_EXTENSION ".sbc"
+
+/**
+ * Sections are addressed by offsets from the start of the artifact, so it can be used wherever it is mapped. The
+ * checksum covers every byte after the header.
+ */
+class ArtifactHeader {
+public:
+    uint32_t magic;
+    uint32_t version;
+    uint64_t checksum;
+    uint64_t size;
+    uint32_t variable_count;
+    uint32_t register_count;
+    uint32_t constant_count;
+    uint32_t instruction_count;
+    uint32_t symbol_count;
+    uint32_t names_size;
+    uint64_t constants_offset;
+    uint64_t types_offset;
+    uint64_t instructions_offset;
+    uint64_t symbols_offset;
+    uint64_t names_offset;
+};
+
+static_assert(sizeof(ArtifactHeader) % alignof(BytecodeValue) == 0, "Constants must stay aligned after the header");
+static_assert(sizeof(SYM_TABLE_DATA_TYPE) == sizeof(uint32_t), "Variable types are stored as 32-bit words");
+
+/**
+ * Declaration of the top level, its name is stored in the name section without terminator. The data type is the type
+ * of the slot when the program ends, the declared type only for slots the program never stores to.
+ */
+class ArtifactSymbol {
+public:
+    uint32_t name_offset;
+    uint32_t name_length;
+    SymbolSlot slot;
+    SYM_TABLE_DATA_TYPE data_type;
+    SYM_TABLE_NODE_FLAG flags;
+};
+
+/**
+ * Collects the symbols of a program and writes its artifact
+ */
+class ArtifactWriter {
+private:
+    std::vector<ArtifactSymbol> symbols;
+    std::string names;
+
+public:
+    ArtifactWriter() = default;
+
+    ~ArtifactWriter() = default;
+
+    void add_symbol(const char *name, size_t length, SymbolSlot slot, SYM_TABLE_DATA_TYPE data_type,
+                    SYM_TABLE_NODE_FLAG flags);
+
+    /**
+     * Adds the declarations of the top level with their declared types, which write replaces by the final types of
+     * their slots. Must run before dead store elimination, which removes declarations.
+     */
+    void add_declarations(SyntaxTree *root_tree);
+
+    /**
+     * @return bytes of the artifact
+     */
+    std::string write(const BytecodeProgram &program) const;
+};
+
+/**
+ * Artifact validated once when it is loaded and then used in place, without copying any section
+ */
+class Artifact {
+private:
+    std::unique_ptr<SourceBuffer> buffer;
+    const ArtifactHeader *header;
+
+    explicit Artifact(SourceBuffer *buffer);
+
+    /**
+     * Checks the header, the checksum and that every offset and register stays inside the artifact
+     */
+    static bool validate(const SourceBuffer *buffer, Diagnostics *diagnostics);
+
+public:
+    Artifact(const Artifact &) = delete;
+
+    Artifact &operator=(const Artifact &) = delete;
+
+    ~Artifact() = default;
+
+    /**
+     * Takes ownership of the buffer
+     * @return nullptr when the buffer is not a valid artifact of this version, the reason is reported
+     */
+    static Artifact *from_buffer(SourceBuffer *buffer, Diagnostics *diagnostics);
+
+    static Artifact *load(const char *path, Diagnostics *diagnostics);
+
+    BytecodeView get_program() const;
+
+    uint32_t get_symbol_count() const;
+
+    const ArtifactSymbol &get_symbol(uint32_t index) const;
+
+    std::string get_name(const ArtifactSymbol &symbol) const;
+
+    /**
+     * @return symbol declared under the name, nullptr when there is none
+     */
+    const ArtifactSymbol *find_symbol(const char *name, size_t length) const;
+};
+
+#endif// SOMA_COMPILER_ARTIFACT_H
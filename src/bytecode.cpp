@@ -0,0 +1,177 @@
+/**
+ * Fixed-width bytecode executed by the virtual machine
+ * @file: bytecode.cpp
+ * @date: 17.10.2026
+ */
+
+#include <cstring>
+#include "bytecode.h"
+#include "compilation_context.h"
+#include "util/errors.h"
+
+// IR opcodes from move on translate to bytecode opcodes by an offset
+constexpr int bytecode_opcode_offset = BC_OP_MOVE - IR_OP_MOVE;
+
+static_assert(BC_OP_INT_TO_FLOAT - IR_OP_INT_TO_FLOAT == bytecode_opcode_offset &&
+                      BC_OP_ADD_INT - IR_OP_ADD_INT == bytecode_opcode_offset &&
+                      BC_OP_SUB_INT - IR_OP_SUB_INT == bytecode_opcode_offset &&
+                      BC_OP_MUL_INT - IR_OP_MUL_INT == bytecode_opcode_offset &&
+                      BC_OP_ADD_FLOAT - IR_OP_ADD_FLOAT == bytecode_opcode_offset &&
+                      BC_OP_SUB_FLOAT - IR_OP_SUB_FLOAT == bytecode_opcode_offset &&
+                      BC_OP_MUL_FLOAT - IR_OP_MUL_FLOAT == bytecode_opcode_offset &&
+                      BC_OP_DIV_FLOAT - IR_OP_DIV_FLOAT == bytecode_opcode_offset,
+              "Bytecode opcodes must follow the order of the IR opcodes");
+
+static const char *const bytecode_opcode_names[BC_OP_COUNT] = {
+        "halt", "move", "itof", "add.i", "sub.i", "mul.i", "add.f", "sub.f", "mul.f", "div.f",
+};
+
+const char *bytecode_opcode_name(BYTECODE_OPCODE opcode) { return bytecode_opcode_names[opcode]; }
+
+static std::string register_name(const BytecodeProgram &program, BytecodeRegister bytecode_register) {
+    const char *prefix = "t";
+    if (bytecode_register < program.variable_count) prefix = "v";
+    else if (bytecode_register < program.variable_count + program.constants.size())
+        prefix = "c";
+
+    return prefix + std::to_string(bytecode_register);
+}
+
+BytecodeView BytecodeProgram::get_view() const {
+    return {instructions.data(), instructions.size(), constants.data(), (uint32_t) constants.size(),
+            variable_count,      register_count,      variable_types.data()};
+}
+
+std::string BytecodeProgram::dump() const {
+    std::string text;
+
+    for (auto &instruction: instructions) {
+        BYTECODE_OPCODE opcode = instruction.get_opcode();
+
+        if (opcode == BC_OP_HALT) {
+            text += "halt\n";
+            continue;
+        }
+
+        text += register_name(*this, instruction.get_dest()) + " = " + bytecode_opcode_name(opcode) + " " +
+                register_name(*this, instruction.operands[0]);
+        if (opcode != BC_OP_MOVE && opcode != BC_OP_INT_TO_FLOAT)
+            text += ", " + register_name(*this, instruction.operands[1]);
+
+        text += "\n";
+    }
+
+    return text;
+}
+
+BytecodeCompiler::BytecodeCompiler(CompilationContext *context, const IrProgram *ir_program)
+    : context(context), ir_program(ir_program) {
+    program.variable_count = ir_program->variable_count;
+    program.variable_types = ir_program->variable_types;
+}
+
+BytecodeRegister BytecodeCompiler::constant_register(const IrInstruction &instruction) {
+    BytecodeValue value{};
+    if (instruction.opcode == IR_OP_CONST_INT) value.set_integer(instruction.integer_value);
+    else
+        value.set_float(instruction.float_value);
+
+    uint64_t bits = value.bits;
+
+    // Registers are untyped, so an integer and a float with the same bits share their register
+    auto known = constant_registers.find(bits);
+    if (known != constant_registers.end()) return known->second;
+
+    BytecodeRegister result = program.variable_count + (BytecodeRegister) program.constants.size();
+    program.constants.push_back(value);
+    constant_registers[bits] = result;
+
+    return result;
+}
+
+void BytecodeCompiler::release(IrRegister ir_register, size_t index) {
+    BytecodeRegister first_temporary = program.variable_count + (BytecodeRegister) program.constants.size();
+
+    if (ir_register >= ir_program->variable_count && last_uses[ir_register] == index &&
+        registers[ir_register] >= first_temporary)
+        free_registers.push_back(registers[ir_register]);
+}
+
+void BytecodeCompiler::emit(BYTECODE_OPCODE opcode, BytecodeRegister dest, BytecodeRegister left,
+                            BytecodeRegister right) {
+    program.instructions.push_back({(uint32_t) opcode | dest << 8, {left, right}});
+}
+
+BytecodeProgram BytecodeCompiler::compile() {
+    const std::vector<IrInstruction> &instructions = ir_program->instructions;
+    registers.assign(ir_program->register_count, 0);
+    last_uses.assign(ir_program->register_count, 0);
+
+    for (SymbolSlot slot = 0; slot < ir_program->variable_count; slot++) registers[slot] = slot;
+
+    // The constants have to be known before the temporaries can be numbered after them
+    for (size_t i = 0; i < instructions.size(); i++) {
+        const IrInstruction &instruction = instructions[i];
+
+        switch (instruction.opcode) {
+            case IR_OP_CONST_INT:
+            case IR_OP_CONST_FLOAT: {
+                BytecodeRegister constant = constant_register(instruction);
+                if (instruction.dest >= ir_program->variable_count) registers[instruction.dest] = constant;
+                break;
+            }
+            case IR_OP_MOVE:
+            case IR_OP_INT_TO_FLOAT:
+                last_uses[instruction.operands[0]] = i;
+                break;
+            default:
+                last_uses[instruction.operands[0]] = i;
+                last_uses[instruction.operands[1]] = i;
+        }
+    }
+
+    BytecodeRegister first_temporary = program.variable_count + (BytecodeRegister) program.constants.size();
+
+    for (size_t i = 0; i < instructions.size(); i++) {
+        const IrInstruction &instruction = instructions[i];
+        bool is_constant = instruction.opcode == IR_OP_CONST_INT || instruction.opcode == IR_OP_CONST_FLOAT;
+
+        // A constant assigned to a temporary needs no instruction, one assigned to a variable is copied
+        if (is_constant && instruction.dest >= ir_program->variable_count) continue;
+
+        bool is_binary = !is_constant && instruction.opcode != IR_OP_MOVE && instruction.opcode != IR_OP_INT_TO_FLOAT;
+        BytecodeRegister left = is_constant ? constant_register(instruction) : registers[instruction.operands[0]];
+        BytecodeRegister right = is_binary ? registers[instruction.operands[1]] : 0;
+
+        // Operands are read before the destination is written, so the destination may take a register they free
+        if (!is_constant) release(instruction.operands[0], i);
+        if (is_binary && instruction.operands[1] != instruction.operands[0]) release(instruction.operands[1], i);
+
+        BytecodeRegister dest = instruction.dest;
+        if (instruction.dest >= ir_program->variable_count) {
+            if (free_registers.empty()) {
+                dest = first_temporary + temporary_count++;
+            } else {
+                dest = free_registers.back();
+                free_registers.pop_back();
+            }
+
+            registers[instruction.dest] = dest;
+        }
+
+        emit(is_constant ? BC_OP_MOVE : (BYTECODE_OPCODE) (instruction.opcode + bytecode_opcode_offset), dest, left,
+             right);
+    }
+
+    emit(BC_OP_HALT, 0, 0, 0);
+    program.register_count = first_temporary + temporary_count;
+
+    if (program.register_count > BYTECODE_REGISTER_LIMIT) {
+        context->get_diagnostics()->report(BYTECODE_REGISTER_LIMIT_ERROR_CODE, 0, 0,
+                                           "Program needs %u registers, at most %u are supported",
+                                           program.register_count, BYTECODE_REGISTER_LIMIT);
+        program.instructions.clear();
+    }
+
+    return program;
+}
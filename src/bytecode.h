@@ -0,0 +1,164 @@
+/**
+ * Fixed-width bytecode executed by the virtual machine
+ * @file: bytecode.h
+ * @date: 17.10.2026
+ */
+
+#ifndef SOMA_COMPILER_BYTECODE_H
+#define SOMA_COMPILER_BYTECODE_H
+
+#include <cstdint>
+#include <cstring>
+#include <string>
+#include <type_traits>
+#include <unordered_map>
+#include <vector>
+#include "ir.h"
+#include "util/types.h"
+
+class CompilationContext;
+
+typedef uint32_t BytecodeRegister;
+
+// Registers are numbered with the 24 bits left next to the opcode
+#define BYTECODE_REGISTER_LIMIT (1u << 24)
+
+typedef enum {
+    BC_OP_HALT,
+    BC_OP_MOVE,
+    BC_OP_INT_TO_FLOAT,
+
+    BC_OP_ADD_INT,
+    BC_OP_SUB_INT,
+    BC_OP_MUL_INT,
+
+    BC_OP_ADD_FLOAT,
+    BC_OP_SUB_FLOAT,
+    BC_OP_MUL_FLOAT,
+    BC_OP_DIV_FLOAT,
+
+    BC_OP_COUNT,
+} BYTECODE_OPCODE;
+
+/**
+ * Three 32-bit words: the opcode in the low byte of the first one and the destination above it, then both operands.
+ * Move and conversion read the first operand only.
+ */
+class BytecodeInstruction {
+public:
+    uint32_t opcode_dest;
+    BytecodeRegister operands[2];
+
+    BYTECODE_OPCODE get_opcode() const { return (BYTECODE_OPCODE) (opcode_dest & 0xff); }
+
+    BytecodeRegister get_dest() const { return opcode_dest >> 8; }
+};
+
+static_assert(sizeof(BytecodeInstruction) == 12, "BytecodeInstruction must stay compact");
+
+/**
+ * Untyped register, the opcode tells how to read it. Registers are shared by values of both types, so the bits are
+ * copied in and out instead of read through a union member that was not the one last written.
+ */
+class BytecodeValue {
+public:
+    uint64_t bits;
+
+    int64_t get_integer() const {
+        int64_t value;
+        memcpy(&value, &bits, sizeof(value));
+
+        return value;
+    }
+
+    double get_float() const {
+        double value;
+        memcpy(&value, &bits, sizeof(value));
+
+        return value;
+    }
+
+    void set_integer(int64_t value) { memcpy(&bits, &value, sizeof(bits)); }
+
+    void set_float(double value) { memcpy(&bits, &value, sizeof(bits)); }
+};
+
+static_assert(sizeof(BytecodeValue) == 8 && std::is_trivially_copyable<BytecodeValue>::value,
+              "Constants are stored in artifacts as 64-bit words");
+
+/**
+ * Read-only view of a bytecode program, over a BytecodeProgram or over a loaded artifact
+ */
+class BytecodeView {
+public:
+    const BytecodeInstruction *instructions;
+    size_t instruction_count;
+    const BytecodeValue *constants;
+    uint32_t constant_count;
+    uint32_t variable_count;
+    uint32_t register_count;
+    const SYM_TABLE_DATA_TYPE *variable_types;
+};
+
+/**
+ * Registers below variable_count hold the variables by slot and are followed by the constants, which are loaded once
+ * before the first run and never written. The temporaries come last and are shared by values that are not live at the
+ * same time. The instructions end with a halt.
+ */
+class BytecodeProgram {
+public:
+    std::vector<BytecodeInstruction> instructions;
+    std::vector<BytecodeValue> constants;
+    uint32_t variable_count = 0;
+    uint32_t register_count = 0;
+    std::vector<SYM_TABLE_DATA_TYPE> variable_types;
+
+    BytecodeView get_view() const;
+
+    /**
+     * @return one instruction per line, registers written as v<register> for variables, c<register> for constants
+     * and t<register> for temporaries
+     */
+    std::string dump() const;
+};
+
+/**
+ * @return the mnemonic of the opcode in dumps, the same as the one of its IR opcode
+ */
+const char *bytecode_opcode_name(BYTECODE_OPCODE opcode);
+
+/**
+ * Translates the IR to bytecode. Constants move to the constant registers, so they cost no instruction at run time,
+ * and temporaries get registers again by their live ranges, which keeps the register file small.
+ */
+class BytecodeCompiler {
+private:
+    CompilationContext *context;
+    const IrProgram *ir_program;
+    BytecodeProgram program;
+    // Constant register of each distinct bit pattern
+    std::unordered_map<uint64_t, BytecodeRegister> constant_registers;
+    // Register given to each IR register, and the index of the last instruction reading each IR temporary
+    std::vector<BytecodeRegister> registers;
+    std::vector<size_t> last_uses;
+    std::vector<BytecodeRegister> free_registers;
+    uint32_t temporary_count = 0;
+
+    BytecodeRegister constant_register(const IrInstruction &instruction);
+
+    void release(IrRegister ir_register, size_t index);
+
+    void emit(BYTECODE_OPCODE opcode, BytecodeRegister dest, BytecodeRegister left, BytecodeRegister right);
+
+public:
+    BytecodeCompiler(CompilationContext *context, const IrProgram *ir_program);
+
+    ~BytecodeCompiler() = default;
+
+    /**
+     * Reports an error when the program needs more registers than an instruction can address
+     */
+    BytecodeProgram compile();
+};
+
+#endif// SOMA_COMPILER_BYTECODE_H
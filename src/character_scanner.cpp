@@ -0,0 +1,219 @@
+/**
+ * Vectorised scanning of character runs used by the lexical analysis
+ * @file: character_scanner.cpp
+ * @date: 17.10.2026
+ */
+
+#include "character_scanner.h"
+#include "util/character_class.h"
+
+#include <initializer_list>
+
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#define CHARACTER_SCANNER_X86
+#include <immintrin.h>
+#endif
+
+static size_t scalar_skip_whitespace(const char *data, size_t position, size_t length, uint32_t *line,
+                                     size_t *line_start) {
+    while (position < length && is_whitespace(data[position])) {
+        if (data[position] == '\n') {
+            (*line)++;
+            *line_start = position + 1;
+        }
+
+        position++;
+    }
+
+    return position;
+}
+
+static size_t scalar_skip_identifier(const char *data, size_t position, size_t length) {
+    while (position < length && is_identifier(data[position])) position++;
+
+    return position;
+}
+
+static size_t scalar_skip_digits(const char *data, size_t position, size_t length) {
+    while (position < length && is_digit(data[position])) position++;
+
+    return position;
+}
+
+#ifdef CHARACTER_SCANNER_X86
+
+/**
+ * Accounts the new lines found in a block of whitespace. Bit i of newline_mask is set when block[i] is a new line.
+ */
+static inline void count_new_lines(uint32_t newline_mask, size_t block_position, uint32_t *line, size_t *line_start) {
+    if (newline_mask == 0) return;
+
+    *line += (uint32_t) __builtin_popcount(newline_mask);
+    *line_start = block_position + (31 - __builtin_clz(newline_mask)) + 1;
+}
+
+static size_t sse2_skip_whitespace(const char *data, size_t position, size_t length, uint32_t *line,
+                                   size_t *line_start) {
+    const __m128i space = _mm_set1_epi8(' ');
+    const __m128i tab = _mm_set1_epi8('\t');
+    const __m128i new_line = _mm_set1_epi8('\n');
+
+    while (position + 16 <= length) {
+        __m128i block = _mm_loadu_si128((const __m128i *) (data + position));
+        __m128i new_lines = _mm_cmpeq_epi8(block, new_line);
+        __m128i whitespace =
+                _mm_or_si128(_mm_or_si128(_mm_cmpeq_epi8(block, space), _mm_cmpeq_epi8(block, tab)), new_lines);
+
+        auto whitespace_mask = (uint32_t) _mm_movemask_epi8(whitespace);
+        auto newline_mask = (uint32_t) _mm_movemask_epi8(new_lines);
+
+        if (whitespace_mask != 0xFFFF) {
+            auto run = (uint32_t) __builtin_ctz(~whitespace_mask);
+            count_new_lines(newline_mask & ((1u << run) - 1), position, line, line_start);
+            return position + run;
+        }
+
+        count_new_lines(newline_mask, position, line, line_start);
+        position += 16;
+    }
+
+    return scalar_skip_whitespace(data, position, length, line, line_start);
+}
+
+static inline __m128i sse2_in_range(__m128i block, char low, char high) {
+    return _mm_and_si128(_mm_cmpgt_epi8(block, _mm_set1_epi8((char) (low - 1))),
+                         _mm_cmplt_epi8(block, _mm_set1_epi8((char) (high + 1))));
+}
+
+static size_t sse2_skip_identifier(const char *data, size_t position, size_t length) {
+    while (position + 16 <= length) {
+        __m128i block = _mm_loadu_si128((const __m128i *) (data + position));
+        __m128i lower = _mm_or_si128(block, _mm_set1_epi8(0x20));
+        __m128i identifier = _mm_or_si128(_mm_or_si128(sse2_in_range(lower, 'a', 'z'), sse2_in_range(block, '0', '9')),
+                                          _mm_cmpeq_epi8(block, _mm_set1_epi8('_')));
+
+        auto mask = (uint32_t) _mm_movemask_epi8(identifier);
+        if (mask != 0xFFFF) return position + __builtin_ctz(~mask);
+
+        position += 16;
+    }
+
+    return scalar_skip_identifier(data, position, length);
+}
+
+static size_t sse2_skip_digits(const char *data, size_t position, size_t length) {
+    while (position + 16 <= length) {
+        __m128i block = _mm_loadu_si128((const __m128i *) (data + position));
+
+        auto mask = (uint32_t) _mm_movemask_epi8(sse2_in_range(block, '0', '9'));
+        if (mask != 0xFFFF) return position + __builtin_ctz(~mask);
+
+        position += 16;
+    }
+
+    return scalar_skip_digits(data, position, length);
+}
+
+__attribute__((target("avx2"))) static size_t avx2_skip_whitespace(const char *data, size_t position, size_t length,
+                                                                   uint32_t *line, size_t *line_start) {
+    const __m256i space = _mm256_set1_epi8(' ');
+    const __m256i tab = _mm256_set1_epi8('\t');
+    const __m256i new_line = _mm256_set1_epi8('\n');
+
+    while (position + 32 <= length) {
+        __m256i block = _mm256_loadu_si256((const __m256i *) (data + position));
+        __m256i new_lines = _mm256_cmpeq_epi8(block, new_line);
+        __m256i whitespace = _mm256_or_si256(
+                _mm256_or_si256(_mm256_cmpeq_epi8(block, space), _mm256_cmpeq_epi8(block, tab)), new_lines);
+
+        auto whitespace_mask = (uint32_t) _mm256_movemask_epi8(whitespace);
+        auto newline_mask = (uint32_t) _mm256_movemask_epi8(new_lines);
+
+        if (whitespace_mask != 0xFFFFFFFF) {
+            auto run = (uint32_t) __builtin_ctz(~whitespace_mask);
+            count_new_lines(newline_mask & ((1u << run) - 1), position, line, line_start);
+            return position + run;
+        }
+
+        count_new_lines(newline_mask, position, line, line_start);
+        position += 32;
+    }
+
+    return sse2_skip_whitespace(data, position, length, line, line_start);
+}
+
+__attribute__((target("avx2"))) static inline __m256i avx2_in_range(__m256i block, char low, char high) {
+    return _mm256_and_si256(_mm256_cmpgt_epi8(block, _mm256_set1_epi8((char) (low - 1))),
+                            _mm256_cmpgt_epi8(_mm256_set1_epi8((char) (high + 1)), block));
+}
+
+__attribute__((target("avx2"))) static size_t avx2_skip_identifier(const char *data, size_t position, size_t length) {
+    while (position + 32 <= length) {
+        __m256i block = _mm256_loadu_si256((const __m256i *) (data + position));
+        __m256i lower = _mm256_or_si256(block, _mm256_set1_epi8(0x20));
+        __m256i identifier =
+                _mm256_or_si256(_mm256_or_si256(avx2_in_range(lower, 'a', 'z'), avx2_in_range(block, '0', '9')),
+                                _mm256_cmpeq_epi8(block, _mm256_set1_epi8('_')));
+
+        auto mask = (uint32_t) _mm256_movemask_epi8(identifier);
+        if (mask != 0xFFFFFFFF) return position + __builtin_ctz(~mask);
+
+        position += 32;
+    }
+
+    return sse2_skip_identifier(data, position, length);
+}
+
+__attribute__((target("avx2"))) static size_t avx2_skip_digits(const char *data, size_t position, size_t length) {
+    while (position + 32 <= length) {
+        __m256i block = _mm256_loadu_si256((const __m256i *) (data + position));
+
+        auto mask = (uint32_t) _mm256_movemask_epi8(avx2_in_range(block, '0', '9'));
+        if (mask != 0xFFFFFFFF) return position + __builtin_ctz(~mask);
+
+        position += 32;
+    }
+
+    return sse2_skip_digits(data, position, length);
+}
+
+#endif
+
+static const CharacterScanner scalar_scanner = {CHAR_SCANNER_SCALAR, scalar_skip_whitespace, scalar_skip_identifier,
+                                                scalar_skip_digits};
+
+#ifdef CHARACTER_SCANNER_X86
+static const CharacterScanner sse2_scanner = {CHAR_SCANNER_SSE2, sse2_skip_whitespace, sse2_skip_identifier,
+                                              sse2_skip_digits};
+
+static const CharacterScanner avx2_scanner = {CHAR_SCANNER_AVX2, avx2_skip_whitespace, avx2_skip_identifier,
+                                              avx2_skip_digits};
+#endif
+
+const CharacterScanner *CharacterScanner::get(CHARACTER_SCANNER_KIND kind) {
+    switch (kind) {
+        case CHAR_SCANNER_SCALAR:
+            return &scalar_scanner;
+#ifdef CHARACTER_SCANNER_X86
+        case CHAR_SCANNER_SSE2:
+            return __builtin_cpu_supports("sse2") ? &sse2_scanner : nullptr;
+        case CHAR_SCANNER_AVX2:
+            return __builtin_cpu_supports("avx2") ? &avx2_scanner : nullptr;
+#endif
+        default:
+            return nullptr;
+    }
+}
+
+const CharacterScanner &CharacterScanner::best() {
+    static const CharacterScanner *scanner = []() {
+        for (auto kind: {CHAR_SCANNER_AVX2, CHAR_SCANNER_SSE2}) {
+            auto candidate = get(kind);
+            if (candidate != nullptr) return candidate;
+        }
+
+        return &scalar_scanner;
+    }();
+
+    return *scanner;
+}
@@ -0,0 +1,59 @@
+/**
+ * Vectorised scanning of character runs used by the lexical analysis
+ * @file: character_scanner.h
+ * @date: 17.10.2026
+ */
+
+#ifndef SOMA_COMPILER_CHARACTER_SCANNER_H
+#define SOMA_COMPILER_CHARACTER_SCANNER_H
+
+#include <cstddef>
+#include <cstdint>
+
+typedef enum {
+    CHAR_SCANNER_SCALAR,
+    CHAR_SCANNER_SSE2,
+    CHAR_SCANNER_AVX2,
+} CHARACTER_SCANNER_KIND;
+
+/**
+ * Set of run scanners for one instruction set. Every function takes the position of the first character of the run
+ * and returns the position of the first character that does not belong to it (or length).
+ */
+class CharacterScanner {
+public:
+    typedef size_t (*WhitespaceScanner)(const char *data, size_t position, size_t length, uint32_t *line,
+                                        size_t *line_start);
+
+    typedef size_t (*RunScanner)(const char *data, size_t position, size_t length);
+
+    CHARACTER_SCANNER_KIND kind;
+
+    /**
+     * Skips spaces, tabs and new lines. Counts new lines into line and moves line_start past the last one.
+     */
+    WhitespaceScanner skip_whitespace;
+
+    /**
+     * Skips [A-Za-z0-9_]
+     */
+    RunScanner skip_identifier;
+
+    /**
+     * Skips [0-9]
+     */
+    RunScanner skip_digits;
+
+    /**
+     * Widest implementation supported by the running CPU. Selected once on first use.
+     */
+    static const CharacterScanner &best();
+
+    /**
+     * Implementation for the given instruction set
+     * @return nullptr when the CPU or the compiler does not support it
+     */
+    static const CharacterScanner *get(CHARACTER_SCANNER_KIND kind);
+};
+
+#endif// SOMA_COMPILER_CHARACTER_SCANNER_H
@@ -0,0 +1,247 @@
+/**
+ * On-disk cache of compilation results keyed by the content of the source
+ * @file: compilation_cache.cpp
+ * @date: 17.10.2026
+ */
+
+#include <algorithm>
+#include <atomic>
+#include <cinttypes>
+#include <cstdio>
+#include <cstring>
+#include <ctime>
+#include <fstream>
+#include <memory>
+#include <vector>
+#include "compilation_cache.h"
+#include "artifact.h"
+#include "driver.h"
+#include "source_buffer.h"
+#include "util/hash.h"
+
+#if defined(__unix__) || defined(__APPLE__)
+#define COMPILATION_CACHE_USE_POSIX
+#include <dirent.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include <utime.h>
+#endif
+
+// "SOMC" read as a little-endian word
+#define CACHE_ENTRY_MAGIC 0x434d4f53u
+
+#define CACHE_ENTRY_EXTENSION ".entry"
+
+// Follows the name of the entry in the names of its temporary files
+#define CACHE_TEMPORARY_EXTENSION ".tmp."
+
+/**
+ * The diagnostics follow the header, each as a record and its message, then the artifact aligned to 8 bytes. The
+ * checksum covers every byte after the header.
+ */
+class CacheEntryHeader {
+public:
+    uint32_t magic;
+    uint32_t version;
+    uint64_t key_first;
+    uint64_t key_second;
+    uint64_t checksum;
+    uint64_t size;
+    uint32_t success;
+    uint32_t variable_count;
+    uint64_t removed_statements;
+    uint64_t instruction_count;
+    uint64_t dropped_diagnostics;
+    uint64_t diagnostic_count;
+    uint64_t artifact_offset;
+    uint64_t artifact_size;
+};
+
+class CacheDiagnosticRecord {
+public:
+    int32_t code;
+    uint32_t line;
+    uint32_t column;
+    uint32_t message_length;
+};
+
+CompilationCache::CompilationCache(const std::string &directory, uint64_t size_limit)
+    : directory(directory), size_limit(size_limit) {
+#ifdef COMPILATION_CACHE_USE_POSIX
+    mkdir(directory.c_str(), 0777);
+#endif
+}
+
+std::string CompilationCache::entry_path(const CacheKey &key) const {
+    char name[40];
+    snprintf(name, sizeof(name), "%016" PRIx64 "%016" PRIx64, key.first, key.second);
+
+    return directory + "/" + name + CACHE_ENTRY_EXTENSION;
+}
+
+CacheKey CompilationCache::get_key(const char *source, size_t length, uint64_t options) {
+    uint64_t versions = (uint64_t) COMPILATION_CACHE_VERSION << 32 | ARTIFACT_VERSION;
+    uint64_t build = hash_bytes(COMPILATION_CACHE_BUILD_ID, strlen(COMPILATION_CACHE_BUILD_ID), versions);
+    uint64_t configuration = mix_hash(build ^ mix_hash(options));
+
+    return {hash_bytes(source, length, configuration), hash_bytes(source, length, mix_hash(~configuration))};
+}
+
+bool CompilationCache::lookup(const CacheKey &key, CompilationResult &result, std::string &artifact_data) const {
+    std::string path = entry_path(key);
+    std::unique_ptr<SourceBuffer> entry(SourceBuffer::map_file(path.c_str()));
+    if (entry == nullptr || entry->get_length() < sizeof(CacheEntryHeader)) return false;
+
+    const char *data = entry->get_data();
+    size_t length = entry->get_length();
+    CacheEntryHeader header{};
+    memcpy(&header, data, sizeof(header));
+
+    if (header.magic != CACHE_ENTRY_MAGIC || header.version != COMPILATION_CACHE_VERSION ||
+        header.key_first != key.first || header.key_second != key.second || header.size != length ||
+        header.checksum != hash_bytes(data + sizeof(header), length - sizeof(header)) ||
+        header.artifact_offset < sizeof(header) || header.artifact_offset > length ||
+        header.artifact_size > length - header.artifact_offset)
+        return false;
+
+    std::vector<Diagnostic> diagnostics;
+    size_t offset = sizeof(header);
+    for (uint64_t i = 0; i < header.diagnostic_count; i++) {
+        CacheDiagnosticRecord record{};
+        // The checksum only catches damage, the records of an entry written by anything else must stay in bounds
+        if (offset + sizeof(record) > header.artifact_offset) return false;
+        memcpy(&record, data + offset, sizeof(record));
+        offset += sizeof(record);
+
+        if (offset + record.message_length > header.artifact_offset) return false;
+        diagnostics.push_back({record.code, record.line, record.column, std::string(data + offset,
+                                                                                     record.message_length)});
+        offset += record.message_length;
+    }
+
+    result.success = header.success != 0;
+    result.variable_count = header.variable_count;
+    result.removed_statements = header.removed_statements;
+    result.instruction_count = header.instruction_count;
+    result.diagnostics = std::move(diagnostics);
+    result.dropped_diagnostics = header.dropped_diagnostics;
+    artifact_data.assign(data + header.artifact_offset, header.artifact_size);
+
+#ifdef COMPILATION_CACHE_USE_POSIX
+    utime(path.c_str(), nullptr);
+#endif
+
+    return true;
+}
+
+void CompilationCache::store(const CacheKey &key, const CompilationResult &result,
+                             const std::string &artifact_data) const {
+    static std::atomic<uint64_t> next_temporary{0};
+
+    CacheEntryHeader header{};
+    header.magic = CACHE_ENTRY_MAGIC;
+    header.version = COMPILATION_CACHE_VERSION;
+    header.key_first = key.first;
+    header.key_second = key.second;
+    header.success = result.success;
+    header.variable_count = result.variable_count;
+    header.removed_statements = result.removed_statements;
+    header.instruction_count = result.instruction_count;
+    header.dropped_diagnostics = result.dropped_diagnostics;
+    header.diagnostic_count = result.diagnostics.size();
+
+    std::string data(sizeof(header), '\0');
+    for (auto &diagnostic: result.diagnostics) {
+        CacheDiagnosticRecord record{diagnostic.code, diagnostic.line, diagnostic.column,
+                                     (uint32_t) diagnostic.message.size()};
+        data.append((const char *) &record, sizeof(record));
+        data += diagnostic.message;
+    }
+
+    data.resize((data.size() + 7) / 8 * 8);
+    header.artifact_offset = data.size();
+    header.artifact_size = artifact_data.size();
+    data += artifact_data;
+
+    header.size = data.size();
+    header.checksum = hash_bytes(data.data() + sizeof(header), data.size() - sizeof(header));
+    memcpy(&data[0], &header, sizeof(header));
+
+    // The temporary name is unique per process and write, the rename replaces any entry written in the meantime
+    std::string path = entry_path(key);
+    long process = 0;
+#ifdef COMPILATION_CACHE_USE_POSIX
+    process = (long) getpid();
+#endif
+    std::string temporary_path =
+            path + CACHE_TEMPORARY_EXTENSION + std::to_string(process) + "." + std::to_string(next_temporary++);
+
+    bool is_written;
+    {
+        std::ofstream file_stream(temporary_path, std::ios::binary | std::ios::trunc);
+        file_stream.write(data.data(), (std::streamsize) data.size());
+        file_stream.close();
+        is_written = !file_stream.fail();
+    }
+
+    if (!is_written || std::rename(temporary_path.c_str(), path.c_str()) != 0) std::remove(temporary_path.c_str());
+}
+
+size_t CompilationCache::evict() const {
+    size_t removed = 0;
+
+#ifdef COMPILATION_CACHE_USE_POSIX
+    struct CacheFile {
+        std::string path;
+        time_t used;
+        uint64_t size;
+    };
+
+    DIR *cache_directory = opendir(directory.c_str());
+    if (cache_directory == nullptr) return 0;
+
+    std::vector<CacheFile> files;
+    uint64_t total_size = 0;
+    size_t extension_length = strlen(CACHE_ENTRY_EXTENSION);
+    time_t now = time(nullptr);
+
+    while (dirent *file = readdir(cache_directory)) {
+        std::string name = file->d_name;
+        bool is_entry = name.size() >= extension_length &&
+                        name.compare(name.size() - extension_length, extension_length, CACHE_ENTRY_EXTENSION) == 0;
+        bool is_temporary = name.find(CACHE_ENTRY_EXTENSION CACHE_TEMPORARY_EXTENSION) != std::string::npos;
+        if (!is_entry && !is_temporary) continue;
+
+        std::string path = directory + "/" + name;
+        struct stat file_stat {};
+        if (stat(path.c_str(), &file_stat) != 0) continue;
+
+        // A writer renames its temporary file right after writing it. One older than the grace period was left by a
+        // writer that died and is never renamed, younger ones may still be in use.
+        if (is_temporary) {
+            if (now - file_stat.st_mtime >= COMPILATION_CACHE_TEMPORARY_GRACE && std::remove(path.c_str()) == 0)
+                removed++;
+            continue;
+        }
+
+        files.push_back({path, file_stat.st_mtime, (uint64_t) file_stat.st_size});
+        total_size += (uint64_t) file_stat.st_size;
+    }
+
+    closedir(cache_directory);
+
+    if (total_size <= size_limit) return removed;
+
+    std::sort(files.begin(), files.end(), [](const CacheFile &a, const CacheFile &b) {
+        return a.used != b.used ? a.used < b.used : a.path < b.path;
+    });
+
+    // Another process may have removed the entry already, its size is then freed all the same
+    for (size_t i = 0; i < files.size() && total_size > size_limit; i++) {
+        if (std::remove(files[i].path.c_str()) == 0) removed++;
+        total_size -= files[i].size;
+    }
+#endif
+
+    return removed;
+}
@@ -0,0 +1,83 @@
+/**
+ * On-disk cache of compilation results keyed by the content of the source
+ * @file: compilation_cache.h
+ * @date: 17.10.2026
+ */
+
+#ifndef SOMA_COMPILER_COMPILATION_CACHE_H
+#define SOMA_COMPILER_COMPILATION_CACHE_H
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+class CompilationResult;
+
+// Raised whenever the layout of the entries changes, older entries are then never read
+#define COMPILATION_CACHE_VERSION 1
+
+// Identifies the compiler that wrote an entry. The build defines it from the compiler sources, so any change to them
+// makes the entries of older builds miss. Without it every compilation of the cache counts as a new compiler.
+#ifndef COMPILATION_CACHE_BUILD_ID
+#define COMPILATION_CACHE_BUILD_ID __DATE__ " " __TIME__
+#endif
+
+#define COMPILATION_CACHE_DEFAULT_LIMIT (256ull << 20)
+
+// Seconds after which eviction removes a temporary file that was never renamed to its entry
+#define COMPILATION_CACHE_TEMPORARY_GRACE 600
+
+/**
+ * Two independent 64-bit hashes of the source, the cache version, the build of the compiler and the options that
+ * change the result
+ */
+class CacheKey {
+public:
+    uint64_t first;
+    uint64_t second;
+};
+
+/**
+ * Every result is stored in its own file named by its key. An entry is written to a temporary file and renamed over
+ * its final name, so concurrent compilers and readers only ever see complete entries. A hit refreshes the
+ * modification time of the entry, which orders the eviction of the least recently used entries.
+ */
+class CompilationCache {
+private:
+    std::string directory;
+    uint64_t size_limit;
+
+    std::string entry_path(const CacheKey &key) const;
+
+public:
+    /**
+     * Creates the directory when it does not exist yet
+     * @param size_limit total size of the entries in bytes that eviction keeps to
+     */
+    explicit CompilationCache(const std::string &directory, uint64_t size_limit = COMPILATION_CACHE_DEFAULT_LIMIT);
+
+    ~CompilationCache() = default;
+
+    static CacheKey get_key(const char *source, size_t length, uint64_t options);
+
+    /**
+     * Fills the result with the stored statistics and diagnostics and the artifact with the stored program
+     * @return false when there is no valid entry for the key, the result is left untouched then
+     */
+    bool lookup(const CacheKey &key, CompilationResult &result, std::string &artifact_data) const;
+
+    /**
+     * Stores the result of a compilation, the artifact is empty when the compilation failed. Failures to write are
+     * ignored, the cache only saves time.
+     */
+    void store(const CacheKey &key, const CompilationResult &result, const std::string &artifact_data) const;
+
+    /**
+     * Removes the temporary files left behind by writers that died, then the least recently used entries until the
+     * rest fits the size limit
+     * @return number of files removed
+     */
+    size_t evict() const;
+};
+
+#endif// SOMA_COMPILER_COMPILATION_CACHE_H
@@ -0,0 +1,22 @@
+/**
+ * Compilation context owning all state of one compilation
+ * @file: compilation_context.cpp
+ * @date: 17.10.2026
+ */
+
+#include "compilation_context.h"
+
+CompilationContext::CompilationContext(size_t diagnostic_limit)
+    : arena(), interner(), symbol_table(), diagnostics(diagnostic_limit), syntax_tree(nullptr) {}
+
+Arena *CompilationContext::get_arena() { return &arena; }
+
+StringInterner *CompilationContext::get_interner() { return &interner; }
+
+ScopedSymbolTable *CompilationContext::get_symbol_table() { return &symbol_table; }
+
+Diagnostics *CompilationContext::get_diagnostics() { return &diagnostics; }
+
+SyntaxTree *CompilationContext::get_syntax_tree() const { return syntax_tree; }
+
+void CompilationContext::set_syntax_tree(SyntaxTree *tree) { this->syntax_tree = tree; }
@@ -0,0 +1,55 @@
+/**
+ * Compilation context owning all state of one compilation
+ * @file: compilation_context.h
+ * @date: 17.10.2026
+ */
+
+#ifndef SOMA_COMPILER_COMPILATION_CONTEXT_H
+#define SOMA_COMPILER_COMPILATION_CONTEXT_H
+
+#include "diagnostics.h"
+#include "string_interner.h"
+#include "symbol_table.h"
+#include "util/arena.h"
+
+class SyntaxTree;
+
+/**
+ * Every syntax tree node and node value of the compilation is allocated in its arena, so the whole tree is released
+ * together with the context. Identifiers are interned in its interner and declared in its symbol table. Nothing is
+ * shared between contexts, so independent compilations may run on separate threads.
+ */
+class CompilationContext {
+private:
+    Arena arena;
+    StringInterner interner;
+    ScopedSymbolTable symbol_table;
+    Diagnostics diagnostics;
+    SyntaxTree *syntax_tree;
+
+public:
+    /**
+     * @param diagnostic_limit number of errors kept before further errors are only counted
+     */
+    explicit CompilationContext(size_t diagnostic_limit = DIAGNOSTICS_DEFAULT_LIMIT);
+
+    CompilationContext(const CompilationContext &) = delete;
+
+    CompilationContext &operator=(const CompilationContext &) = delete;
+
+    ~CompilationContext() = default;
+
+    Arena *get_arena();
+
+    StringInterner *get_interner();
+
+    ScopedSymbolTable *get_symbol_table();
+
+    Diagnostics *get_diagnostics();
+
+    SyntaxTree *get_syntax_tree() const;
+
+    void set_syntax_tree(SyntaxTree *tree);
+};
+
+#endif// SOMA_COMPILER_COMPILATION_CONTEXT_H
@@ -0,0 +1,88 @@
+/**
+ * Stages of compiling one source, in the order the driver runs them
+ * @file: compilation_pipeline.cpp
+ * @date: 17.10.2026
+ */
+
+#include "compilation_pipeline.h"
+#include "artifact.h"
+#include "ir_lowering.h"
+#include "lexical_analysis.h"
+#include "optimiser.h"
+#include "semantic_analysis.h"
+#include "source_buffer.h"
+#include "syntax_analysis.h"
+#include "value_numbering.h"
+
+CompilationPipeline::CompilationPipeline(size_t diagnostic_limit)
+    : context(diagnostic_limit), slot_count(0), removed_count(0), instruction_count(0) {}
+
+bool CompilationPipeline::analyze(SourceBuffer *source) {
+    Diagnostics *diagnostics = context.get_diagnostics();
+
+    LexicalAnalysis lexical_analysis(source);
+    SyntaxAnalysis syntax_analysis(&lexical_analysis, &context);
+    SyntaxTree *syntax_tree = syntax_analysis.build_tree();
+
+    SemanticAnalysis semantic_analysis(&context);
+    if (!diagnostics->has_errors()) semantic_analysis.analyze_tree(syntax_tree);
+    slot_count = semantic_analysis.get_slot_count();
+
+    return !diagnostics->has_errors();
+}
+
+bool CompilationPipeline::analyze(const std::string &text) {
+    SourceBuffer source(text.data(), text.size());
+
+    return analyze(&source);
+}
+
+size_t CompilationPipeline::optimize() {
+    Optimiser optimiser(&context);
+    optimiser.optimize();
+
+    return optimiser.eliminate_dead_stores();
+}
+
+void CompilationPipeline::share_values() {
+    ValueNumbering value_numbering(&context);
+    value_numbering.share();
+}
+
+IrProgram CompilationPipeline::lower() {
+    IrLowering ir_lowering(&context, slot_count);
+
+    return ir_lowering.lower();
+}
+
+BytecodeProgram CompilationPipeline::compile(const IrProgram &ir_program) {
+    BytecodeCompiler bytecode_compiler(&context, &ir_program);
+
+    return bytecode_compiler.compile();
+}
+
+std::string CompilationPipeline::build_artifact() {
+    ArtifactWriter artifact_writer;
+    artifact_writer.add_declarations(context.get_syntax_tree());
+
+    removed_count = optimize();
+    share_values();
+
+    IrProgram ir_program = lower();
+    instruction_count = ir_program.instructions.size();
+
+    BytecodeProgram bytecode = compile(ir_program);
+    if (context.get_diagnostics()->has_errors()) return "";
+
+    return artifact_writer.write(bytecode);
+}
+
+CompilationContext *CompilationPipeline::get_context() { return &context; }
+
+SyntaxTree *CompilationPipeline::get_syntax_tree() const { return context.get_syntax_tree(); }
+
+SymbolSlot CompilationPipeline::get_slot_count() const { return slot_count; }
+
+size_t CompilationPipeline::get_removed_count() const { return removed_count; }
+
+size_t CompilationPipeline::get_instruction_count() const { return instruction_count; }
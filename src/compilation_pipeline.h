@@ -0,0 +1,92 @@
+/**
+ * Stages of compiling one source, in the order the driver runs them
+ * @file: compilation_pipeline.h
+ * @date: 17.10.2026
+ */
+
+#ifndef SOMA_COMPILER_COMPILATION_PIPELINE_H
+#define SOMA_COMPILER_COMPILATION_PIPELINE_H
+
+#include <cstddef>
+#include <string>
+#include "bytecode.h"
+#include "compilation_context.h"
+#include "ir.h"
+#include "util/types.h"
+
+class SourceBuffer;
+
+class SyntaxTree;
+
+/**
+ * Runs the stages of a compilation over one context. Each stage works on the tree the stages before it left, so
+ * callers may run only some of them and inspect the context in between. Errors are reported to the diagnostics of
+ * the context.
+ */
+class CompilationPipeline {
+private:
+    CompilationContext context;
+    SymbolSlot slot_count;
+    size_t removed_count;
+    size_t instruction_count;
+
+public:
+    /**
+     * @param diagnostic_limit number of errors kept before further errors are only counted
+     */
+    explicit CompilationPipeline(size_t diagnostic_limit = DIAGNOSTICS_DEFAULT_LIMIT);
+
+    ~CompilationPipeline() = default;
+
+    /**
+     * Lexical, syntax and semantic analysis of the source. Statements with syntax errors are missing from the tree,
+     * analysing the rest would report follow-up errors, so the semantic analysis only runs without them.
+     * @return false after errors
+     */
+    bool analyze(SourceBuffer *source);
+
+    bool analyze(const std::string &text);
+
+    /**
+     * Propagates values and removes dead stores
+     * @return number of statements removed
+     */
+    size_t optimize();
+
+    /**
+     * Shares equal subexpressions of the tree
+     */
+    void share_values();
+
+    IrProgram lower();
+
+    BytecodeProgram compile(const IrProgram &ir_program);
+
+    /**
+     * Runs every stage after the analysis. The declarations of the top level are collected before optimising, as
+     * dead store elimination drops some of them.
+     * @return data of the artifact, empty after errors
+     */
+    std::string build_artifact();
+
+    CompilationContext *get_context();
+
+    SyntaxTree *get_syntax_tree() const;
+
+    /**
+     * @return number of slots assigned by the semantic analysis
+     */
+    SymbolSlot get_slot_count() const;
+
+    /**
+     * @return number of statements removed by build_artifact
+     */
+    size_t get_removed_count() const;
+
+    /**
+     * @return number of IR instructions lowered by build_artifact
+     */
+    size_t get_instruction_count() const;
+};
+
+#endif// SOMA_COMPILER_COMPILATION_PIPELINE_H
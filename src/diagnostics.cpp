@@ -0,0 +1,54 @@
+/**
+ * Diagnostics collected during a compilation
+ * @file: diagnostics.cpp
+ * @date: 17.10.2026
+ */
+
+#include <algorithm>
+#include <cstdio>
+#include "diagnostics.h"
+
+Diagnostics::Diagnostics(size_t limit) : limit(limit), dropped(0) {}
+
+void Diagnostics::report(int code, uint32_t line, uint32_t column, const char *format, ...) {
+    va_list args;
+    va_start(args, format);
+    report_list(code, line, column, format, args);
+    va_end(args);
+}
+
+void Diagnostics::report_list(int code, uint32_t line, uint32_t column, const char *format, va_list args) {
+    if (is_full()) {
+        dropped++;
+        return;
+    }
+
+    // Formatted once into a stack buffer, the only allocation is the message itself
+    char buffer[DIAGNOSTIC_MESSAGE_LIMIT];
+    int length = vsnprintf(buffer, sizeof(buffer), format, args);
+    if (length < 0) length = 0;
+    if ((size_t) length >= sizeof(buffer)) length = sizeof(buffer) - 1;
+
+    diagnostics.push_back(Diagnostic{code, line, column, std::string(buffer, (size_t) length)});
+}
+
+void Diagnostics::sort_by_position() {
+    std::stable_sort(diagnostics.begin(), diagnostics.end(), [](const Diagnostic &a, const Diagnostic &b) {
+        return a.line != b.line ? a.line < b.line : a.column < b.column;
+    });
+}
+
+void Diagnostics::clear() {
+    diagnostics.clear();
+    dropped = 0;
+}
+
+bool Diagnostics::has_errors() const { return !diagnostics.empty(); }
+
+bool Diagnostics::is_full() const { return diagnostics.size() >= limit; }
+
+size_t Diagnostics::get_dropped_count() const { return dropped; }
+
+const std::vector<Diagnostic> &Diagnostics::get_diagnostics() const { return diagnostics; }
+
+size_t Diagnostics::size() const { return diagnostics.size(); }
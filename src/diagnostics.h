@@ -0,0 +1,77 @@
+/**
+ * Diagnostics collected during a compilation
+ * @file: diagnostics.h
+ * @date: 17.10.2026
+ */
+
+#ifndef SOMA_COMPILER_DIAGNOSTICS_H
+#define SOMA_COMPILER_DIAGNOSTICS_H
+
+#include <cstdarg>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#define DIAGNOSTICS_DEFAULT_LIMIT 100
+
+// Longest message kept, longer messages are truncated
+#define DIAGNOSTIC_MESSAGE_LIMIT 256
+
+/**
+ * Error with its position in the source. Line and column start at 1, 0 means the error has no position.
+ */
+class Diagnostic {
+public:
+    int code;
+    uint32_t line;
+    uint32_t column;
+    std::string message;
+};
+
+/**
+ * Collects errors instead of aborting, so one pass reports every error of a source. Once the limit is reached further
+ * errors are only counted, and the analyses stop early.
+ */
+class Diagnostics {
+private:
+    std::vector<Diagnostic> diagnostics;
+    size_t limit;
+    size_t dropped;
+
+public:
+    explicit Diagnostics(size_t limit = DIAGNOSTICS_DEFAULT_LIMIT);
+
+    ~Diagnostics() = default;
+
+    /**
+     * Records an error with a printf style message
+     */
+    void report(int code, uint32_t line, uint32_t column, const char *format, ...);
+
+    void report_list(int code, uint32_t line, uint32_t column, const char *format, va_list args);
+
+    /**
+     * Orders the diagnostics by their position in the source. Diagnostics at the same position keep their order.
+     */
+    void sort_by_position();
+
+    /**
+     * Forgets the errors reported so far
+     */
+    void clear();
+
+    bool has_errors() const;
+
+    bool is_full() const;
+
+    /**
+     * @return number of errors reported after the limit was reached
+     */
+    size_t get_dropped_count() const;
+
+    const std::vector<Diagnostic> &get_diagnostics() const;
+
+    size_t size() const;
+};
+
+#endif// SOMA_COMPILER_DIAGNOSTICS_H
@@ -0,0 +1,164 @@
+/**
+ * Driver compiling many source files in parallel
+ * @file: driver.cpp
+ * @date: 17.10.2026
+ */
+
+#include <cstring>
+#include <fstream>
+#include <memory>
+#include "driver.h"
+#include "artifact.h"
+#include "compilation_pipeline.h"
+#include "bytecode.h"
+#include "vm.h"
+#include "source_buffer.h"
+#include "util/errors.h"
+
+Driver::Driver(size_t thread_count, const DriverOptions &options) : pool(thread_count), options(options) {
+    if (!options.cache_directory.empty())
+        cache.reset(new CompilationCache(options.cache_directory, options.cache_size_limit));
+}
+
+uint64_t DriverOptions::get_cache_options() const { return diagnostic_limit; }
+
+static bool write_file(const std::string &path, const std::string &data) {
+    std::ofstream file_stream(path, std::ios::binary | std::ios::trunc);
+    file_stream.write(data.data(), (std::streamsize) data.size());
+
+    return file_stream.good();
+}
+
+/**
+ * Executes the artifact and reports the final values of its variables
+ */
+static void run_artifact(const Artifact &artifact, CompilationResult &result) {
+    BytecodeView program = artifact.get_program();
+
+    VirtualMachine machine(program);
+    machine.run();
+
+    for (uint32_t i = 0; i < artifact.get_symbol_count(); i++) {
+        const ArtifactSymbol &symbol = artifact.get_symbol(i);
+        if (symbol.flags & SYM_TABLE_IS_CONSTANT) continue;
+
+        result.values.emplace_back(artifact.get_name(symbol), machine.get_variable(symbol.slot).get_text());
+    }
+}
+
+static bool has_suffix(const std::string &text, const char *suffix) {
+    size_t length = strlen(suffix);
+
+    return text.size() >= length && text.compare(text.size() - length, length, suffix) == 0;
+}
+
+/**
+ * Writes the artifact of a successful compilation and executes it, each when requested
+ */
+static void run_compiled_artifact(const DriverOptions &options, const std::string &artifact_data,
+                                  CompilationResult &result) {
+    if (!result.success || (!options.write_artifacts && !options.run_programs)) return;
+
+    Diagnostics diagnostics;
+
+    std::string artifact_path = result.path + ARTIFACT_EXTENSION;
+    if (options.write_artifacts && !write_file(artifact_path, artifact_data))
+        diagnostics.report(DRIVER_WRITE_FILE_ERROR_CODE, 0, 0, "Cannot write file %s", artifact_path.c_str());
+
+    // The program runs from its artifact, exactly as it would after being loaded
+    if (options.run_programs) {
+        std::unique_ptr<Artifact> artifact(
+                Artifact::from_buffer(new SourceBuffer(artifact_data.data(), artifact_data.size()), &diagnostics));
+        if (artifact != nullptr) run_artifact(*artifact, result);
+    }
+
+    result.diagnostics.insert(result.diagnostics.end(), diagnostics.get_diagnostics().begin(),
+                              diagnostics.get_diagnostics().end());
+    result.success = !diagnostics.has_errors();
+}
+
+CompilationResult Driver::run_artifact_file(const std::string &path) {
+    CompilationResult result{path, false, 0, 0, 0, {}, {}, 0};
+    Diagnostics diagnostics;
+
+    std::unique_ptr<Artifact> artifact(Artifact::load(path.c_str(), &diagnostics));
+    if (artifact != nullptr) {
+        BytecodeView program = artifact->get_program();
+        result.variable_count = program.variable_count;
+        result.instruction_count = program.instruction_count - (program.instruction_count > 0);
+
+        run_artifact(*artifact, result);
+    }
+
+    result.diagnostics = diagnostics.get_diagnostics();
+    result.dropped_diagnostics = diagnostics.get_dropped_count();
+    result.success = !diagnostics.has_errors();
+
+    return result;
+}
+
+CompilationResult Driver::compile_file(const std::string &path, const DriverOptions &options,
+                                       const CompilationCache *cache) {
+    CompilationResult result{path, false, 0, 0, 0, {}, {}, 0};
+
+    std::unique_ptr<SourceBuffer> source(SourceBuffer::map_file(path.c_str()));
+    if (source == nullptr) {
+        Diagnostics diagnostics;
+        diagnostics.report(DRIVER_OPEN_FILE_ERROR_CODE, 0, 0, "Cannot open file %s", path.c_str());
+        result.diagnostics = diagnostics.get_diagnostics();
+
+        return result;
+    }
+
+    CacheKey key{};
+    std::string artifact_data;
+    if (cache != nullptr) {
+        key = CompilationCache::get_key(source->get_data(), source->get_length(), options.get_cache_options());
+
+        if (cache->lookup(key, result, artifact_data)) {
+            run_compiled_artifact(options, artifact_data, result);
+            return result;
+        }
+    }
+
+    CompilationPipeline pipeline(options.diagnostic_limit);
+    Diagnostics *diagnostics = pipeline.get_context()->get_diagnostics();
+
+    if (pipeline.analyze(source.get())) {
+        artifact_data = pipeline.build_artifact();
+        result.removed_statements = pipeline.get_removed_count();
+        result.instruction_count = pipeline.get_instruction_count();
+    }
+
+    result.variable_count = pipeline.get_slot_count();
+    result.diagnostics = diagnostics->get_diagnostics();
+    result.dropped_diagnostics = diagnostics->get_dropped_count();
+    result.success = !diagnostics->has_errors();
+
+    if (cache != nullptr) cache->store(key, result, artifact_data);
+
+    run_compiled_artifact(options, artifact_data, result);
+
+    return result;
+}
+
+std::vector<CompilationResult> Driver::compile_files(const std::vector<std::string> &paths) {
+    std::vector<CompilationResult> results(paths.size());
+
+    // Each task writes only its own result, so no further synchronisation is needed
+    for (size_t i = 0; i < paths.size(); i++) {
+        pool.submit([this, &results, &paths, i]() {
+            if (has_suffix(paths[i], ARTIFACT_EXTENSION)) results[i] = run_artifact_file(paths[i]);
+            else
+                results[i] = compile_file(paths[i], options, cache.get());
+        });
+    }
+
+    pool.wait();
+
+    if (cache != nullptr) cache->evict();
+
+    return results;
+}
+
+size_t Driver::get_thread_count() const { return pool.get_thread_count(); }
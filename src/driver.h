@@ -0,0 +1,87 @@
+/**
+ * Driver compiling many source files in parallel
+ * @file: driver.h
+ * @date: 17.10.2026
+ */
+
+#ifndef SOMA_COMPILER_DRIVER_H
+#define SOMA_COMPILER_DRIVER_H
+
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+#include "compilation_cache.h"
+#include "diagnostics.h"
+#include "thread_pool.h"
+#include "util/types.h"
+
+class CompilationResult {
+public:
+    std::string path;
+    bool success;
+    SymbolSlot variable_count;
+    size_t removed_statements;
+    // IR instructions of a source, bytecode instructions of an artifact
+    size_t instruction_count;
+    // Final values of the variables declared with var at the top level, in declaration order
+    std::vector<std::pair<std::string, std::string>> values;
+    std::vector<Diagnostic> diagnostics;
+    size_t dropped_diagnostics;
+};
+
+class DriverOptions {
+public:
+    // Writes the artifact of every compiled source next to it, named by appending ARTIFACT_EXTENSION to its path
+    bool write_artifacts = false;
+    // Executes every compiled program and reports the final values of its variables
+    bool run_programs = false;
+    // Results are cached in the directory when it is set
+    std::string cache_directory;
+    uint64_t cache_size_limit = COMPILATION_CACHE_DEFAULT_LIMIT;
+    // Number of errors reported for a source before further errors are only counted
+    size_t diagnostic_limit = DIAGNOSTICS_DEFAULT_LIMIT;
+
+    /**
+     * @return the options that change the result of a compilation, which are part of its cache key
+     */
+    uint64_t get_cache_options() const;
+};
+
+/**
+ * Every file is compiled as an independent task with its own compilation context. Paths ending with
+ * ARTIFACT_EXTENSION are loaded and executed without compiling.
+ */
+class Driver {
+private:
+    ThreadPool pool;
+    DriverOptions options;
+    std::unique_ptr<CompilationCache> cache;
+
+public:
+    /**
+     * @param thread_count number of worker threads, 0 for one per hardware thread
+     */
+    explicit Driver(size_t thread_count = 0, const DriverOptions &options = DriverOptions());
+
+    ~Driver() = default;
+
+    /**
+     * Runs lexical, syntax and semantic analysis and the optimisation passes on one file, then executes it when the
+     * options ask for it. A source found in the cache skips all passes.
+     */
+    static CompilationResult compile_file(const std::string &path, const DriverOptions &options = DriverOptions(),
+                                          const CompilationCache *cache = nullptr);
+
+    static CompilationResult run_artifact_file(const std::string &path);
+
+    /**
+     * Evicts from the cache once all files are compiled
+     * @return results in the order of the paths, independent of the order in which the tasks finished
+     */
+    std::vector<CompilationResult> compile_files(const std::vector<std::string> &paths);
+
+    size_t get_thread_count() const;
+};
+
+#endif// SOMA_COMPILER_DRIVER_H
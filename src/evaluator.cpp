@@ -0,0 +1,107 @@
+/**
+ * Tree-walking evaluator executing checked programs
+ * @file: evaluator.cpp
+ * @date: 17.10.2026
+ */
+
+#include "evaluator.h"
+#include "optimiser.h"
+#include "syntax_analysis.h"
+#include "compilation_context.h"
+#include "util/number_format.h"
+#include "util/small_stack.h"
+
+std::string RuntimeValue::get_text() const {
+    if (type == SYM_TABLE_TYPE_INT) return std::to_string(integer_value);
+    if (type == SYM_TABLE_TYPE_FLOAT) return format_double(float_value);
+
+    return "";
+}
+
+Evaluator::Evaluator(CompilationContext *context, SymbolSlot variable_count)
+    : context(context), values(variable_count, RuntimeValue{SYM_TABLE_TYPE_UNKNOWN, {0}}) {}
+
+RuntimeValue Evaluator::evaluate(SyntaxTree *expression) {
+    SmallStack<RuntimeValue, SYN_TREE_TRAVERSAL_INLINE_DEPTH> operands;
+
+    // The operators are the ones constant folding uses, so folded and evaluated results agree
+    expression->process_tree_using(
+            [&](SyntaxTree *node) {
+                RuntimeValue result{};
+
+                switch (node->type) {
+                    case SYN_NODE_IDENTIFIER:
+                        result = values[node->slot];
+                        break;
+                    case SYN_NODE_INTEGER_LITERAL:
+                        result.type = SYM_TABLE_TYPE_INT;
+                        result.integer_value = node->integer_value;
+                        break;
+                    case SYN_NODE_FLOAT_LITERAL:
+                        result.type = SYM_TABLE_TYPE_FLOAT;
+                        result.float_value = node->float_value;
+                        break;
+                    default: {
+                        // An operand shared by both sides of an operator is visited once in postorder
+                        RuntimeValue right = operands.top();
+                        operands.pop();
+                        RuntimeValue left = right;
+                        if (node->left != node->right) {
+                            left = operands.top();
+                            operands.pop();
+                        }
+
+                        const OptimiserOperator &op = optimiser_operators[optimiser_operator_index(node->type)];
+
+                        if (op.fold_integer != nullptr && left.type == SYM_TABLE_TYPE_INT &&
+                            right.type == SYM_TABLE_TYPE_INT) {
+                            result.type = SYM_TABLE_TYPE_INT;
+                            result.integer_value = op.fold_integer(left.integer_value, right.integer_value);
+                        } else {
+                            double left_number =
+                                    left.type == SYM_TABLE_TYPE_FLOAT ? left.float_value : (double) left.integer_value;
+                            double right_number = right.type == SYM_TABLE_TYPE_FLOAT ? right.float_value
+                                                                                      : (double) right.integer_value;
+
+                            result.type = SYM_TABLE_TYPE_FLOAT;
+                            result.float_value = op.fold_float(left_number, right_number);
+                        }
+                    }
+                }
+
+                operands.push(result);
+            },
+            POSTORDER);
+
+    return operands.top();
+}
+
+void Evaluator::run_statements(SyntaxTree *list) {
+    // Expression statements have no effect, so they are not evaluated
+    for (uint32_t i = 0; i < list->statement_count; i++) {
+        SyntaxTree *statement = list->statements[i];
+
+        if (statement->type == SYN_NODE_ASSIGNMENT) values[statement->left->slot] = evaluate(statement->right);
+        else if (statement->type == SYN_NODE_BLOCK) run_statements(statement);
+    }
+}
+
+void Evaluator::run() {
+    SyntaxTree *root_tree = context->get_syntax_tree();
+
+    if (root_tree != nullptr) run_statements(root_tree);
+}
+
+const RuntimeValue &Evaluator::get_value(SymbolSlot slot) const { return values[slot]; }
+
+const RuntimeValue *Evaluator::find_variable(const char *name, size_t length) {
+    // Only the top level declarations are left in the symbol table once the analysis has closed every block
+    SymbolId symbol = context->get_interner()->find(name, length);
+    SymbolTableEntry *entry = symbol == SYMBOL_ID_NONE ? nullptr : context->get_symbol_table()->find(symbol);
+
+    if (entry == nullptr || entry->data.get_slot() >= values.size()) return nullptr;
+
+    const RuntimeValue &value = values[entry->data.get_slot()];
+
+    return value.type == SYM_TABLE_TYPE_UNKNOWN ? nullptr : &value;
+}
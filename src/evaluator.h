@@ -0,0 +1,67 @@
+/**
+ * Tree-walking evaluator executing checked programs
+ * @file: evaluator.h
+ * @date: 17.10.2026
+ */
+
+#ifndef SOMA_COMPILER_EVALUATOR_H
+#define SOMA_COMPILER_EVALUATOR_H
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+#include "util/types.h"
+
+class SyntaxTree;
+
+class CompilationContext;
+
+/**
+ * Integer or float value, the type is unknown for a variable that was never assigned
+ */
+class RuntimeValue {
+public:
+    SYM_TABLE_DATA_TYPE type;
+    union {
+        int64_t integer_value;
+        double float_value;
+    };
+
+    std::string get_text() const;
+};
+
+/**
+ * Runs the program on its syntax tree, optimised or not, and keeps the values of all variables in an array indexed
+ * by slot. It defines the semantics every other backend has to reproduce: integer arithmetic wraps around, an
+ * operator with a float operand and division compute in double.
+ */
+class Evaluator {
+private:
+    CompilationContext *context;
+    std::vector<RuntimeValue> values;
+
+    RuntimeValue evaluate(SyntaxTree *expression);
+
+    void run_statements(SyntaxTree *list);
+
+public:
+    /**
+     * @param variable_count number of slots given out by the semantic analysis
+     */
+    Evaluator(CompilationContext *context, SymbolSlot variable_count);
+
+    ~Evaluator() = default;
+
+    void run();
+
+    const RuntimeValue &get_value(SymbolSlot slot) const;
+
+    /**
+     * @return value of the variable declared at the top level under the name, nullptr when there is no such
+     * variable or it was never assigned
+     */
+    const RuntimeValue *find_variable(const char *name, size_t length);
+};
+
+#endif// SOMA_COMPILER_EVALUATOR_H
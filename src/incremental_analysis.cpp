@@ -0,0 +1,562 @@
+/**
+ * Incremental analysis of a source edited in place, for editors
+ * @file: incremental_analysis.cpp
+ * @date: 17.10.2026
+ */
+
+#include <algorithm>
+#include <cstdint>
+#include <iterator>
+#include <unordered_set>
+#include "incremental_analysis.h"
+#include "compilation_context.h"
+#include "lexical_analysis.h"
+#include "semantic_analysis.h"
+#include "source_buffer.h"
+#include "syntax_analysis.h"
+#include "util/errors.h"
+
+static const IncrementalSymbol undeclared_symbol = {false, SYM_TABLE_TYPE_UNKNOWN, SYM_TABLE_NO_FLAG};
+
+bool IncrementalSymbol::operator==(const IncrementalSymbol &other) const {
+    return is_declared == other.is_declared && type == other.type && flags == other.flags;
+}
+
+bool IncrementalSymbol::operator!=(const IncrementalSymbol &other) const { return !(*this == other); }
+
+IncrementalSpan IncrementalSpan::operator+(const IncrementalSpan &other) const {
+    return IncrementalSpan{length + other.length, newline_count + other.newline_count,
+                           other.newline_count > 0 ? other.last_line_length : last_line_length + other.length};
+}
+
+static size_t subtree_count(const IncrementalStatement *node) { return node != nullptr ? node->subtree_count : 0; }
+
+static IncrementalSpan subtree_span(const IncrementalStatement *node) {
+    return node != nullptr ? node->subtree_span : IncrementalSpan{0, 0, 0};
+}
+
+static void update_subtree(IncrementalStatement *node) {
+    node->subtree_count = subtree_count(node->left) + 1 + subtree_count(node->right);
+    node->subtree_span = subtree_span(node->left) + node->span + subtree_span(node->right);
+
+    if (node->left != nullptr) node->left->parent = node;
+    if (node->right != nullptr) node->right->parent = node;
+}
+
+/**
+ * @return root of the statements of the left tree followed by those of the right one
+ */
+static IncrementalStatement *merge_trees(IncrementalStatement *left, IncrementalStatement *right) {
+    IncrementalStatement *root;
+
+    if (left == nullptr || right == nullptr) {
+        root = left != nullptr ? left : right;
+    } else if (left->priority > right->priority) {
+        root = left;
+        root->right = merge_trees(left->right, right);
+    } else {
+        root = right;
+        root->left = merge_trees(left, right->left);
+    }
+
+    if (root != nullptr) {
+        update_subtree(root);
+        root->parent = nullptr;
+    }
+
+    return root;
+}
+
+/**
+ * Splits the tree into its first count statements and the others
+ */
+static void split_tree(IncrementalStatement *node, size_t count, IncrementalStatement *&left,
+                       IncrementalStatement *&right) {
+    if (node == nullptr) {
+        left = right = nullptr;
+        return;
+    }
+
+    if (subtree_count(node->left) < count) {
+        split_tree(node->right, count - subtree_count(node->left) - 1, node->right, right);
+        left = node;
+    } else {
+        split_tree(node->left, count, left, node->left);
+        right = node;
+    }
+
+    update_subtree(node);
+    if (left != nullptr) left->parent = nullptr;
+    if (right != nullptr) right->parent = nullptr;
+}
+
+static void destroy_tree(IncrementalStatement *node) {
+    if (node == nullptr) return;
+
+    destroy_tree(node->left);
+    destroy_tree(node->right);
+    delete node;
+}
+
+static IncrementalStatement *select_statement(IncrementalStatement *node, size_t index) {
+    while (subtree_count(node->left) != index) {
+        if (index < subtree_count(node->left)) {
+            node = node->left;
+        } else {
+            index -= subtree_count(node->left) + 1;
+            node = node->right;
+        }
+    }
+
+    return node;
+}
+
+static IncrementalStatement *next_statement(IncrementalStatement *node) {
+    if (node->right != nullptr) {
+        for (node = node->right; node->left != nullptr;) node = node->left;
+        return node;
+    }
+
+    while (node->parent != nullptr && node == node->parent->right) node = node->parent;
+
+    return node->parent;
+}
+
+static size_t statement_index(const IncrementalStatement *node) {
+    size_t index = subtree_count(node->left);
+    for (; node->parent != nullptr; node = node->parent)
+        if (node == node->parent->right) index += subtree_count(node->parent->left) + 1;
+
+    return index;
+}
+
+/**
+ * @return span of the text before the statement
+ */
+static IncrementalSpan preceding_span(const IncrementalStatement *node) {
+    IncrementalSpan span = subtree_span(node->left);
+    for (; node->parent != nullptr; node = node->parent)
+        if (node == node->parent->right) span = subtree_span(node->parent->left) + node->parent->span + span;
+
+    return span;
+}
+
+/**
+ * @return number of statements starting before the position, or at it when inclusive
+ */
+static size_t count_starting_before(const IncrementalStatement *node, size_t position, bool is_inclusive) {
+    size_t count = 0, start = 0;
+
+    while (node != nullptr) {
+        size_t node_start = start + subtree_span(node->left).length;
+
+        if (node_start < position || (is_inclusive && node_start == position)) {
+            count += subtree_count(node->left) + 1;
+            start = node_start + node->span.length;
+            node = node->right;
+        } else {
+            node = node->left;
+        }
+    }
+
+    return count;
+}
+
+bool IncrementalStatementOrder::operator()(const IncrementalStatement *statement,
+                                           const IncrementalStatement *other) const {
+    return statement != other && statement_index(statement) < statement_index(other);
+}
+
+static bool is_before(uint32_t line, uint32_t column, uint32_t other_line, uint32_t other_column) {
+    return line < other_line || (line == other_line && column < other_column);
+}
+
+/**
+ * Moves the diagnostic from the text a statement was parsed from to the start of the statement
+ */
+static Diagnostic relative_diagnostic(const Diagnostic &diagnostic, const IncrementalStatement &statement) {
+    Diagnostic relative = diagnostic;
+    relative.line = diagnostic.line - statement.parse_line;
+    if (relative.line == 0) relative.column = diagnostic.column - statement.parse_column + 1;
+
+    return relative;
+}
+
+/**
+ * Moves the diagnostic from the start of a statement to the statement starting at the line and column
+ */
+static Diagnostic absolute_diagnostic(const Diagnostic &relative, uint32_t line, uint32_t column) {
+    Diagnostic diagnostic = relative;
+    diagnostic.line = line + relative.line;
+    if (relative.line == 0) diagnostic.column = column + relative.column - 1;
+
+    return diagnostic;
+}
+
+IncrementalAnalysis::IncrementalAnalysis(const std::string &text)
+    : context(new CompilationContext(SIZE_MAX)), statements(nullptr), live_bytes(0), names(new StringInterner()),
+      reparsed_count(0), reanalyzed_count(0) {
+    apply_edit(0, 0, text);
+}
+
+IncrementalAnalysis::~IncrementalAnalysis() { destroy_tree(statements); }
+
+INCREMENTAL_PARSE_RESULT IncrementalAnalysis::parse_range(size_t &position, size_t end,
+                                                          std::vector<std::unique_ptr<IncrementalStatement>> &parsed,
+                                                          size_t &next_start, size_t removed_length,
+                                                          size_t inserted_length) {
+    Arena *arena = context->get_arena();
+    context->get_diagnostics()->clear();
+
+    SourceBuffer source(text.data() + position, end - position);
+    LexicalAnalysis lexical_analysis(&source);
+    SyntaxAnalysis syntax_analysis(&lexical_analysis, context.get());
+    syntax_analysis.start_statements();
+
+    // Starts of the statements parsed here as positions in the range, followed by the end of the last one
+    std::vector<std::pair<uint32_t, uint32_t>> bounds{{1, 1}};
+    size_t first = parsed.size(), statement_start = 0;
+    INCREMENTAL_PARSE_RESULT result = INCREMENTAL_PARSE_RANGE_END;
+
+    // The lexical analysis stops at a null character, which ends the source as well
+    auto is_source_end = [&]() {
+        return syntax_analysis.is_at_end() &&
+               (end == text.size() || syntax_analysis.peek_token(0).offset < end - position);
+    };
+
+    while (true) {
+        if (syntax_analysis.is_at_end()) {
+            if (is_source_end()) result = INCREMENTAL_PARSE_SOURCE_END;
+            break;
+        }
+
+        size_t allocated_bytes = arena->get_allocated_bytes();
+        SyntaxTree *tree = syntax_analysis.statement();
+
+        // A statement that ran into the end of the range may continue in the text after it
+        if (syntax_analysis.is_at_end() && !is_source_end()) break;
+
+        LexicalToken last = syntax_analysis.get_previous_token();
+        size_t statement_end = last.offset + last.length;
+
+        std::unique_ptr<IncrementalStatement> statement(new IncrementalStatement());
+        statement->tree = tree;
+        statement->tree_bytes = arena->get_allocated_bytes() - allocated_bytes;
+        statement->span.length = statement_end - statement_start;
+        statement->span.newline_count = 0;
+        statement->span.last_line_length = statement->span.length;
+        statement->parse_line = bounds.back().first;
+        statement->parse_column = bounds.back().second;
+        statement->is_analyzed = false;
+        statement->parent = statement->left = statement->right = nullptr;
+        statement->priority = (uint32_t) priorities();
+        update_subtree(statement.get());
+
+        const char *statement_text = text.data() + position + statement_start;
+        for (size_t i = 0; i < statement->span.length; i++) {
+            if (statement_text[i] != '\n') continue;
+
+            statement->span.newline_count++;
+            statement->span.last_line_length = statement->span.length - i - 1;
+        }
+
+        if (tree != nullptr) {
+            std::unordered_set<SymbolId> seen;
+            StringInterner *interner = context->get_interner();
+
+            tree->process_tree_using(
+                    [&](SyntaxTree *node) {
+                        if (node->type != SYN_NODE_IDENTIFIER || !seen.insert(node->symbol).second) return;
+
+                        statement->names.emplace_back(node->symbol,
+                                                     names->intern(interner->get_text(node->symbol),
+                                                                  interner->get_length(node->symbol)));
+                    },
+                    PREORDER);
+        }
+
+        parsed.push_back(std::move(statement));
+
+        // Statements end with a single character token, so the next one starts on the same line
+        bounds.emplace_back(last.line, last.column + last.length);
+        statement_start = statement_end;
+
+        if (is_source_end()) {
+            result = INCREMENTAL_PARSE_SOURCE_END;
+            break;
+        }
+
+        // The old statements from here on are unchanged once one of them starts where the new statement ended
+        size_t count = subtree_count(statements), next_offset = 0;
+        for (; next_start < count; next_start++) {
+            next_offset = get_start(next_start) - removed_length + inserted_length;
+            if (next_offset >= position + statement_end) break;
+        }
+        if (next_start < count && next_offset == position + statement_end) {
+            result = INCREMENTAL_PARSE_SYNCHRONIZED;
+            break;
+        }
+    }
+
+    // Errors past the last statement kept belong to text that is parsed again or kept from before
+    size_t count = parsed.size() - first;
+    for (auto &diagnostic: context->get_diagnostics()->get_diagnostics()) {
+        if (count == 0) break;
+
+        auto bound = std::upper_bound(bounds.begin() + 1, bounds.end(),
+                                      std::make_pair(diagnostic.line, diagnostic.column));
+        auto index = (size_t) (bound - bounds.begin() - 1);
+
+        if (index == count) {
+            if (result != INCREMENTAL_PARSE_SOURCE_END) continue;
+            index--;
+        }
+
+        IncrementalStatement &statement = *parsed[first + index];
+        statement.syntax_diagnostics.push_back(relative_diagnostic(diagnostic, statement));
+    }
+
+    position += statement_start;
+
+    return result;
+}
+
+size_t IncrementalAnalysis::get_start(size_t index) const {
+    return preceding_span(select_statement(statements, index)).length;
+}
+
+void IncrementalAnalysis::apply_edit(size_t offset, size_t length, const std::string &replacement) {
+    offset = std::min(offset, text.size());
+    length = std::min(length, text.size() - offset);
+    text.replace(offset, length, replacement);
+    compact_if_needed();
+
+    // The statement holding the offset is the first one parsed again, the statements before it end with their last
+    // token and never see the text after it. The statements starting past the edit move with the text after it.
+    size_t count = subtree_count(statements), edit_end = offset + length;
+    size_t first = count > 0 ? count_starting_before(statements, offset, true) - 1 : 0;
+    size_t next = std::max(first + 1, count_starting_before(statements, edit_end, false));
+
+    auto moved_start = [&](size_t index) { return get_start(index) - length + replacement.size(); };
+
+    std::vector<std::unique_ptr<IncrementalStatement>> parsed;
+    size_t position = count > 0 ? get_start(first) : 0;
+    size_t next_start = next, last = next;
+    INCREMENTAL_PARSE_RESULT result = INCREMENTAL_PARSE_RANGE_END;
+
+    // Removing whole statements leaves the statement after them where the first one removed started
+    if (next_start < count && moved_start(next_start) == position) result = INCREMENTAL_PARSE_SYNCHRONIZED;
+
+    while (result == INCREMENTAL_PARSE_RANGE_END) {
+        // The text of one more old statement is parsed, so a statement ending where it starts is recognised as
+        // ended. Every retry reaches twice as far.
+        last = std::max(last, next_start);
+        size_t end = last < count ? moved_start(last) + select_statement(statements, last)->span.length : text.size();
+
+        result = parse_range(position, end, parsed, next_start, length, replacement.size());
+        last += last - next_start + 1;
+    }
+
+    reparsed_count = parsed.size();
+    replace_statements(first, result == INCREMENTAL_PARSE_SYNCHRONIZED ? next_start : count, parsed);
+}
+
+void IncrementalAnalysis::replace_statements(size_t first, size_t kept,
+                                             std::vector<std::unique_ptr<IncrementalStatement>> &parsed) {
+    // The sets order statements by the tree, so the removed statements leave them before they leave the tree
+    std::vector<SymbolId> removed_names;
+    IncrementalStatement *statement = first < kept ? select_statement(statements, first) : nullptr;
+
+    for (size_t i = first; i < kept; i++, statement = next_statement(statement)) {
+        for (auto &name: statement->names) {
+            mentions[name.second].erase(statement);
+            removed_names.push_back(name.second);
+        }
+
+        syntax_erroneous.erase(statement);
+        semantic_erroneous.erase(statement);
+        live_bytes -= statement->tree_bytes;
+    }
+
+    IncrementalStatement *before, *removed, *after, *inserted = nullptr;
+    split_tree(statements, first, before, after);
+    split_tree(after, kept - first, removed, after);
+    destroy_tree(removed);
+
+    for (auto &parsed_statement: parsed) inserted = merge_trees(inserted, parsed_statement.release());
+    statements = merge_trees(merge_trees(before, inserted), after);
+
+    IncrementalStatementSet pending;
+    mentions.resize(names->size());
+    statement = first < subtree_count(statements) ? select_statement(statements, first) : nullptr;
+
+    for (size_t i = 0; i < parsed.size(); i++, statement = next_statement(statement)) {
+        for (size_t j = 0; j < statement->names.size(); j++) mentions[statement->names[j].second][statement] = j;
+
+        if (!statement->syntax_diagnostics.empty()) syntax_erroneous.insert(statement);
+        if (statement->tree != nullptr) pending.insert(statement);
+        live_bytes += statement->tree_bytes;
+    }
+
+    // The statement that mentions a name of a removed statement next may see another state of it now
+    for (auto name: removed_names) {
+        auto &statements_of_name = mentions[name];
+        auto mention = statement != nullptr ? statements_of_name.lower_bound(statement) : statements_of_name.end();
+        if (mention == statements_of_name.end()) continue;
+
+        // A new statement mentioning the name before it passes the state on once it is checked
+        if (mention != statements_of_name.begin() && !std::prev(mention)->first->is_analyzed) continue;
+        if (mention->first->inputs[mention->second] != get_input(mention->first, name)) pending.insert(mention->first);
+    }
+
+    analyze_statements(pending);
+}
+
+void IncrementalAnalysis::compact_if_needed() {
+    size_t dead_bytes = context->get_arena()->get_allocated_bytes() - live_bytes;
+    if (dead_bytes <= std::max(live_bytes, (size_t) INCREMENTAL_ANALYSIS_DEAD_LIMIT)) return;
+
+    mentions.clear();
+    syntax_erroneous.clear();
+    semantic_erroneous.clear();
+    destroy_tree(statements);
+    statements = nullptr;
+    live_bytes = 0;
+    context.reset(new CompilationContext(SIZE_MAX));
+    names.reset(new StringInterner());
+}
+
+IncrementalSymbol IncrementalAnalysis::get_input(IncrementalStatement *statement, SymbolId name) const {
+    auto &statements_of_name = mentions[name];
+    auto mention = statements_of_name.lower_bound(statement);
+    if (mention == statements_of_name.begin()) return undeclared_symbol;
+
+    mention--;
+
+    return mention->first->outputs[mention->second];
+}
+
+void IncrementalAnalysis::analyze_statement(IncrementalStatement *statement) {
+    ScopedSymbolTable *symbol_table = context->get_symbol_table();
+    context->get_diagnostics()->clear();
+
+    statement->inputs.clear();
+    statement->outputs.clear();
+    statement->semantic_diagnostics.clear();
+
+    // Only the names of the statement are looked up, so they are all it needs to be checked on its own
+    for (auto &name: statement->names) {
+        statement->inputs.push_back(get_input(statement, name.second));
+
+        if (!statement->inputs.back().is_declared) continue;
+
+        SymbolTableEntry *entry = symbol_table->declare(name.first);
+        entry->data.set_type(statement->inputs.back().type);
+        entry->data.set_flag(statement->inputs.back().flags);
+    }
+
+    SyntaxTree *tree = statement->tree;
+    SyntaxTree sequence(SYN_NODE_SEQUENCE, &tree, 1);
+
+    SemanticAnalysis semantic_analysis(context.get());
+    semantic_analysis.analyze_tree(&sequence);
+
+    for (auto &name: statement->names) {
+        SymbolTableEntry *entry = symbol_table->find(name.first);
+        statement->outputs.push_back(entry != nullptr ? IncrementalSymbol{true, entry->data.get_type(),
+                                                                          entry->data.get_flags()}
+                                                      : undeclared_symbol);
+        symbol_table->remove(name.first);
+    }
+
+    for (auto &diagnostic: context->get_diagnostics()->get_diagnostics())
+        statement->semantic_diagnostics.push_back(relative_diagnostic(diagnostic, *statement));
+
+    if (statement->semantic_diagnostics.empty()) semantic_erroneous.erase(statement);
+    else
+        semantic_erroneous.insert(statement);
+
+    statement->is_analyzed = true;
+}
+
+void IncrementalAnalysis::analyze_statements(IncrementalStatementSet &pending) {
+    reanalyzed_count = 0;
+
+    while (!pending.empty()) {
+        IncrementalStatement *statement = *pending.begin();
+        pending.erase(pending.begin());
+
+        analyze_statement(statement);
+        reanalyzed_count++;
+
+        // Statements after the next one mentioning a name see the state that one leaves
+        for (size_t i = 0; i < statement->names.size(); i++) {
+            auto &statements_of_name = mentions[statement->names[i].second];
+            auto mention = statements_of_name.upper_bound(statement);
+            if (mention == statements_of_name.end()) continue;
+
+            IncrementalStatement *next_mention = mention->first;
+            if (!next_mention->is_analyzed || next_mention->inputs[mention->second] != statement->outputs[i])
+                pending.insert(next_mention);
+        }
+    }
+}
+
+const std::string &IncrementalAnalysis::get_text() const { return text; }
+
+std::vector<Diagnostic> IncrementalAnalysis::get_diagnostics() const {
+    std::vector<Diagnostic> diagnostics, syntax_diagnostics, semantic_diagnostics;
+
+    for (auto statement: syntax_erroneous) {
+        IncrementalSpan span = preceding_span(statement);
+        auto line = span.newline_count + 1, column = (uint32_t) span.last_line_length + 1;
+
+        for (auto &diagnostic: statement->syntax_diagnostics) {
+            auto &list = diagnostic.code == LEXICAL_ANALYSIS_ERROR_CODE ? diagnostics : syntax_diagnostics;
+            list.push_back(absolute_diagnostic(diagnostic, line, column));
+        }
+    }
+
+    for (auto statement: semantic_erroneous) {
+        IncrementalSpan span = preceding_span(statement);
+        auto line = span.newline_count + 1, column = (uint32_t) span.last_line_length + 1;
+
+        for (auto &diagnostic: statement->semantic_diagnostics)
+            semantic_diagnostics.push_back(absolute_diagnostic(diagnostic, line, column));
+    }
+
+    // Like the driver, which lexes the whole source before parsing it and checks only sources without errors. The
+    // errors reported first are kept up to the limit.
+    if (diagnostics.empty() && syntax_diagnostics.empty()) {
+        if (semantic_diagnostics.size() > DIAGNOSTICS_DEFAULT_LIMIT)
+            semantic_diagnostics.resize(DIAGNOSTICS_DEFAULT_LIMIT);
+
+        return semantic_diagnostics;
+    }
+
+    diagnostics.insert(diagnostics.end(), syntax_diagnostics.begin(), syntax_diagnostics.end());
+    if (diagnostics.size() > DIAGNOSTICS_DEFAULT_LIMIT) diagnostics.resize(DIAGNOSTICS_DEFAULT_LIMIT);
+
+    std::stable_sort(diagnostics.begin(), diagnostics.end(), [](const Diagnostic &a, const Diagnostic &b) {
+        return is_before(a.line, a.column, b.line, b.column);
+    });
+
+    return diagnostics;
+}
+
+SYM_TABLE_DATA_TYPE IncrementalAnalysis::get_type(const std::string &name) const {
+    SymbolId id = names->find(name.data(), name.size());
+    if (id == SYMBOL_ID_NONE || id >= mentions.size() || mentions[id].empty()) return SYM_TABLE_TYPE_UNKNOWN;
+
+    auto last = mentions[id].rbegin();
+
+    return last->first->outputs[last->second].type;
+}
+
+size_t IncrementalAnalysis::get_statement_count() const { return subtree_count(statements); }
+
+size_t IncrementalAnalysis::get_reparsed_count() const { return reparsed_count; }
+
+size_t IncrementalAnalysis::get_reanalyzed_count() const { return reanalyzed_count; }
+
+size_t IncrementalAnalysis::get_allocated_bytes() const { return context->get_arena()->get_allocated_bytes(); }
@@ -0,0 +1,226 @@
+/**
+ * Incremental analysis of a source edited in place, for editors
+ * @file: incremental_analysis.h
+ * @date: 17.10.2026
+ */
+
+#ifndef SOMA_COMPILER_INCREMENTAL_ANALYSIS_H
+#define SOMA_COMPILER_INCREMENTAL_ANALYSIS_H
+
+#include <map>
+#include <memory>
+#include <random>
+#include <set>
+#include <string>
+#include <utility>
+#include <vector>
+#include "diagnostics.h"
+#include "string_interner.h"
+#include "symbol_table.h"
+#include "util/types.h"
+
+class CompilationContext;
+
+class SyntaxTree;
+
+/**
+ * State of a top level name as seen by a statement
+ */
+class IncrementalSymbol {
+public:
+    bool is_declared;
+    SYM_TABLE_DATA_TYPE type;
+    SYM_TABLE_NODE_FLAG flags;
+
+    bool operator==(const IncrementalSymbol &other) const;
+
+    bool operator!=(const IncrementalSymbol &other) const;
+};
+
+/**
+ * Length of a text along with the line its end is on
+ */
+class IncrementalSpan {
+public:
+    size_t length;
+    uint32_t newline_count;
+    // Characters after the last newline, all of them when there is none
+    size_t last_line_length;
+
+    /**
+     * @return span of the text followed by the other text
+     */
+    IncrementalSpan operator+(const IncrementalSpan &other) const;
+};
+
+/**
+ * Statement of the top level with the text it was parsed from. The text of a statement runs from the end of the
+ * previous one to its last token, so the statements cover the source without gaps. Diagnostics are kept relative to
+ * the start of the statement: line 0 is the line it starts on, where columns count from its first character.
+ */
+class IncrementalStatement {
+public:
+    // nullptr after a syntax error
+    SyntaxTree *tree;
+    // Bytes of the arena of the analysis taken by the tree
+    size_t tree_bytes;
+    IncrementalSpan span;
+    // Position of the first character in the text the statement was parsed from
+    uint32_t parse_line;
+    uint32_t parse_column;
+    // Lexical errors followed by syntax errors, each in the order they were reported
+    std::vector<Diagnostic> syntax_diagnostics;
+    std::vector<Diagnostic> semantic_diagnostics;
+    // Every name the statement mentions, as the symbol of its tree and the name of the analysis
+    std::vector<std::pair<SymbolId, SymbolId>> names;
+    // States of the names before and after the statement, by the index of the name
+    std::vector<IncrementalSymbol> inputs;
+    std::vector<IncrementalSymbol> outputs;
+    bool is_analyzed;
+    // Links of the treap holding the statements in text order, balanced by random priorities
+    IncrementalStatement *parent;
+    IncrementalStatement *left;
+    IncrementalStatement *right;
+    uint32_t priority;
+    // Statements of the subtree and their text
+    size_t subtree_count;
+    IncrementalSpan subtree_span;
+};
+
+/**
+ * Orders statements of the same tree by their position in the text. Positions are found by walking up the tree, so
+ * they need not be updated when statements are inserted or removed elsewhere.
+ */
+class IncrementalStatementOrder {
+public:
+    bool operator()(const IncrementalStatement *statement, const IncrementalStatement *other) const;
+};
+
+typedef std::set<IncrementalStatement *, IncrementalStatementOrder> IncrementalStatementSet;
+
+// Statements mentioning a name, with the index of the name in each
+typedef std::map<IncrementalStatement *, size_t, IncrementalStatementOrder> IncrementalMentions;
+
+// Bytes of replaced trees the arena may hold before it is compacted, unless the live trees take even more
+#define INCREMENTAL_ANALYSIS_DEAD_LIMIT (256 * 1024)
+
+typedef enum {
+    INCREMENTAL_PARSE_RANGE_END,
+    INCREMENTAL_PARSE_SYNCHRONIZED,
+    INCREMENTAL_PARSE_SOURCE_END,
+} INCREMENTAL_PARSE_RESULT;
+
+/**
+ * Keeps the analysis of a source up to date while it is edited. An edit is lexed and parsed again from the start of
+ * the first statement it touches until a statement ends where an unchanged statement starts, the statements after
+ * that point are kept. A statement is checked again only when the state of a name it mentions changed, and a change
+ * is passed on only to the next statement mentioning the name. The results equal those of analysing the whole source
+ * again. Statements are kept in a tree by their lengths rather than their offsets, so an edit costs time logarithmic
+ * in the number of statements besides the statements it parses and checks.
+ */
+class IncrementalAnalysis {
+private:
+    std::string text;
+    // Allocates the trees of all statements and interns their identifiers. Its symbol table checks one statement at a
+    // time and is left empty in between.
+    std::unique_ptr<CompilationContext> context;
+    // Root of the tree owning the statements
+    IncrementalStatement *statements;
+    // Bytes of the arena taken by the trees of the statements
+    size_t live_bytes;
+    std::minstd_rand priorities;
+    // Names of all statements, the statements mentioning each name are kept by its id
+    std::unique_ptr<StringInterner> names;
+    std::vector<IncrementalMentions> mentions;
+    // Statements with errors, so collecting the errors does not walk all statements
+    IncrementalStatementSet syntax_erroneous;
+    IncrementalStatementSet semantic_erroneous;
+    size_t reparsed_count;
+    size_t reanalyzed_count;
+
+    /**
+     * Parses statements of the text from the position up to the end, appending them to the list. A statement that
+     * runs into the end of the range is dropped unless the range ends the source, as it may continue after it.
+     * @param position start of the first statement, moved past the statements appended
+     * @param next_start index of the first old statement that starts at or after the position, the old statements
+     * from there on follow the edit that replaced removed_length characters with inserted_length ones
+     */
+    INCREMENTAL_PARSE_RESULT parse_range(size_t &position, size_t end,
+                                         std::vector<std::unique_ptr<IncrementalStatement>> &parsed, size_t &next_start,
+                                         size_t removed_length, size_t inserted_length);
+
+    /**
+     * @return offset of the statement at the index in the text before the edit
+     */
+    size_t get_start(size_t index) const;
+
+    /**
+     * Replaces the statements from first up to kept with the parsed ones and checks the statements affected
+     */
+    void replace_statements(size_t first, size_t kept, std::vector<std::unique_ptr<IncrementalStatement>> &parsed);
+
+    /**
+     * Drops the statements along with the context and names once the trees of replaced statements take more of the
+     * arena than the live ones, so the next parse starts over in a new context. Parsing the whole text again costs no
+     * more than the edits that left the dead trees behind.
+     */
+    void compact_if_needed();
+
+    /**
+     * @return state of the name after the statements before the statement mentioning it
+     */
+    IncrementalSymbol get_input(IncrementalStatement *statement, SymbolId name) const;
+
+    /**
+     * Checks the statement against the states of its names before it, recording the states after it
+     */
+    void analyze_statement(IncrementalStatement *statement);
+
+    /**
+     * Checks the pending statements in order, adding the next statement mentioning a name whose state changed
+     */
+    void analyze_statements(IncrementalStatementSet &pending);
+
+public:
+    explicit IncrementalAnalysis(const std::string &text);
+
+    ~IncrementalAnalysis();
+
+    /**
+     * Replaces length characters at the offset with the replacement and updates the analysis
+     */
+    void apply_edit(size_t offset, size_t length, const std::string &replacement);
+
+    const std::string &get_text() const;
+
+    /**
+     * @return the errors the driver reports for the text: lexical and syntax errors in order of their position, or
+     * semantic errors in statement order when there are none, up to the default limit
+     */
+    std::vector<Diagnostic> get_diagnostics() const;
+
+    /**
+     * @return type of the name after the last statement, unknown for names that are not declared at the top level.
+     * Unlike the driver, the statements are checked despite errors elsewhere, so editors can still show the types.
+     */
+    SYM_TABLE_DATA_TYPE get_type(const std::string &name) const;
+
+    size_t get_statement_count() const;
+
+    /**
+     * @return number of statements parsed by the last edit
+     */
+    size_t get_reparsed_count() const;
+
+    /**
+     * @return number of statements checked by the last edit
+     */
+    size_t get_reanalyzed_count() const;
+
+    /**
+     * @return bytes of the arena holding the trees, including the trees of replaced statements
+     */
+    size_t get_allocated_bytes() const;
+};
+
+#endif// SOMA_COMPILER_INCREMENTAL_ANALYSIS_H
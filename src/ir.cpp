@@ -0,0 +1,60 @@
+/**
+ * Three-address intermediate representation
+ * @file: ir.cpp
+ * @date: 17.10.2026
+ */
+
+#include "ir.h"
+#include "util/number_format.h"
+
+static const char *const ir_opcode_names[IR_OP_COUNT] = {
+        "const.i", "const.f", "move", "itof", "add.i", "sub.i", "mul.i", "add.f", "sub.f", "mul.f", "div.f",
+};
+
+const char *ir_opcode_name(IR_OPCODE opcode) { return ir_opcode_names[opcode]; }
+
+SYM_TABLE_DATA_TYPE ir_result_type(IR_OPCODE opcode) {
+    switch (opcode) {
+        case IR_OP_CONST_INT:
+        case IR_OP_ADD_INT:
+        case IR_OP_SUB_INT:
+        case IR_OP_MUL_INT:
+            return SYM_TABLE_TYPE_INT;
+        case IR_OP_MOVE:
+            return SYM_TABLE_TYPE_UNKNOWN;
+        default:
+            return SYM_TABLE_TYPE_FLOAT;
+    }
+}
+
+static std::string register_name(const IrProgram &program, IrRegister ir_register) {
+    return (ir_register < program.variable_count ? "v" : "t") + std::to_string(ir_register);
+}
+
+std::string IrProgram::dump() const {
+    std::string text;
+
+    for (auto &instruction: instructions) {
+        text += register_name(*this, instruction.dest) + " = " + ir_opcode_name(instruction.opcode) + " ";
+
+        switch (instruction.opcode) {
+            case IR_OP_CONST_INT:
+                text += std::to_string(instruction.integer_value);
+                break;
+            case IR_OP_CONST_FLOAT:
+                text += format_double(instruction.float_value);
+                break;
+            case IR_OP_MOVE:
+            case IR_OP_INT_TO_FLOAT:
+                text += register_name(*this, instruction.operands[0]);
+                break;
+            default:
+                text += register_name(*this, instruction.operands[0]) + ", " +
+                        register_name(*this, instruction.operands[1]);
+        }
+
+        text += "\n";
+    }
+
+    return text;
+}
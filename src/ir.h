@@ -0,0 +1,83 @@
+/**
+ * Three-address intermediate representation
+ * @file: ir.h
+ * @date: 17.10.2026
+ */
+
+#ifndef SOMA_COMPILER_IR_H
+#define SOMA_COMPILER_IR_H
+
+#include <cstdint>
+#include <string>
+#include <vector>
+#include "util/types.h"
+
+typedef uint32_t IrRegister;
+
+#define IR_REGISTER_NONE ((IrRegister) -1)
+
+typedef enum {
+    IR_OP_CONST_INT,
+    IR_OP_CONST_FLOAT,
+    IR_OP_MOVE,
+    IR_OP_INT_TO_FLOAT,
+
+    IR_OP_ADD_INT,
+    IR_OP_SUB_INT,
+    IR_OP_MUL_INT,
+
+    IR_OP_ADD_FLOAT,
+    IR_OP_SUB_FLOAT,
+    IR_OP_MUL_FLOAT,
+    IR_OP_DIV_FLOAT,
+
+    IR_OP_COUNT,
+} IR_OPCODE;
+
+/**
+ * dest = operands[0] op operands[1]. Constants carry their number instead of operands, move and conversion read
+ * operands[0] only.
+ */
+class IrInstruction {
+public:
+    IR_OPCODE opcode;
+    IrRegister dest;
+    union {
+        IrRegister operands[2];
+        int64_t integer_value;
+        double float_value;
+    };
+};
+
+static_assert(sizeof(IrInstruction) == 16, "IrInstruction must stay compact");
+
+/**
+ * Straight-line program over virtual registers. Registers below variable_count hold the variables by slot, the
+ * others are temporaries written once. Registers are untyped, the opcode tells how to read its registers.
+ */
+class IrProgram {
+public:
+    std::vector<IrInstruction> instructions;
+    uint32_t variable_count = 0;
+    uint32_t register_count = 0;
+    // Type of the last value stored to each variable, unknown for variables that are never stored
+    std::vector<SYM_TABLE_DATA_TYPE> variable_types;
+
+    /**
+     * @return one instruction per line, variables written as v<slot> and temporaries as t<register>. The format is
+     * stable, so tests compare it as text.
+     */
+    std::string dump() const;
+};
+
+/**
+ * @return the mnemonic of the opcode in dumps
+ */
+const char *ir_opcode_name(IR_OPCODE opcode);
+
+/**
+ * @return type of the value written by the opcode
+ */
+SYM_TABLE_DATA_TYPE ir_result_type(IR_OPCODE opcode);
+
+#endif// SOMA_COMPILER_IR_H
@@ -0,0 +1,138 @@
+/**
+ * Lowering of the checked syntax tree to the three-address intermediate representation
+ * @file: ir_lowering.cpp
+ * @date: 17.10.2026
+ */
+
+#include "ir_lowering.h"
+#include "syntax_analysis.h"
+#include "compilation_context.h"
+
+IrLowering::IrLowering(CompilationContext *context, SymbolSlot variable_count) : root_tree(context->get_syntax_tree()) {
+    program.variable_count = variable_count;
+    program.register_count = variable_count;
+    program.variable_types.assign(variable_count, SYM_TABLE_TYPE_UNKNOWN);
+}
+
+IrRegister IrLowering::new_temporary() { return program.register_count++; }
+
+IrInstruction &IrLowering::emit(IR_OPCODE opcode, IrRegister dest) {
+    IrInstruction instruction{};
+    instruction.opcode = opcode;
+    instruction.dest = dest;
+    program.instructions.push_back(instruction);
+
+    return program.instructions.back();
+}
+
+IrRegister IrLowering::operand(SyntaxTree *node, IrRegister operand_register, bool is_float) {
+    if (!is_float || node->data_type != SYM_TABLE_TYPE_INT) return operand_register;
+
+    auto conversion = converted.find(node);
+    if (conversion != converted.end()) return conversion->second;
+
+    IrRegister dest = new_temporary();
+    emit(IR_OP_INT_TO_FLOAT, dest).operands[0] = operand_register;
+
+    // Value numbering gives a reassigned variable new nodes, so a node always stands for the same value
+    converted[node] = dest;
+
+    return dest;
+}
+
+void IrLowering::lower_expression(SyntaxTree *expression, IrRegister dest) {
+    operands.clear();
+
+    // Operands are lowered before their operator, their registers wait on the operand stack
+    expression->process_tree_using(
+            [&](SyntaxTree *node) {
+                bool is_root = node == expression;
+
+                if (node->type == SYN_NODE_IDENTIFIER) {
+                    operands.push_back(node->slot);
+                    return;
+                }
+
+                // An operand shared by both sides of an operator is visited once in postorder
+                IrRegister right = IR_REGISTER_NONE, left = IR_REGISTER_NONE;
+                if (node->left != nullptr) {
+                    right = operands.back();
+                    operands.pop_back();
+                    left = right;
+                    if (node->left != node->right) {
+                        left = operands.back();
+                        operands.pop_back();
+                    }
+                }
+
+                auto known = lowered.find(node);
+                if (known != lowered.end()) {
+                    operands.push_back(known->second);
+                    return;
+                }
+
+                IrRegister result;
+
+                if (node->type == SYN_NODE_INTEGER_LITERAL) {
+                    result = is_root ? dest : new_temporary();
+                    emit(IR_OP_CONST_INT, result).integer_value = node->integer_value;
+                } else if (node->type == SYN_NODE_FLOAT_LITERAL) {
+                    result = is_root ? dest : new_temporary();
+                    emit(IR_OP_CONST_FLOAT, result).float_value = node->float_value;
+                } else {
+                    bool is_float = node->data_type == SYM_TABLE_TYPE_FLOAT;
+                    left = operand(node->left, left, is_float);
+                    right = operand(node->right, right, is_float);
+                    result = is_root ? dest : new_temporary();
+
+                    IR_OPCODE opcode;
+                    switch (node->type) {
+                        case SYN_NODE_ADD:
+                            opcode = is_float ? IR_OP_ADD_FLOAT : IR_OP_ADD_INT;
+                            break;
+                        case SYN_NODE_SUB:
+                            opcode = is_float ? IR_OP_SUB_FLOAT : IR_OP_SUB_INT;
+                            break;
+                        case SYN_NODE_MUL:
+                            opcode = is_float ? IR_OP_MUL_FLOAT : IR_OP_MUL_INT;
+                            break;
+                        default:
+                            opcode = IR_OP_DIV_FLOAT;
+                    }
+
+                    IrInstruction &instruction = emit(opcode, result);
+                    instruction.operands[0] = left;
+                    instruction.operands[1] = right;
+                }
+
+                // Variables are overwritten later, temporaries never are
+                if (result >= program.variable_count) lowered[node] = result;
+                operands.push_back(result);
+            },
+            POSTORDER);
+
+    // A variable or an expression computed before is copied
+    if (operands.back() != dest) emit(IR_OP_MOVE, dest).operands[0] = operands.back();
+}
+
+void IrLowering::lower_statements(SyntaxTree *list) {
+    // Expression statements have no effect and produce no instructions
+    for (uint32_t i = 0; i < list->statement_count; i++) {
+        SyntaxTree *statement = list->statements[i];
+
+        if (statement->type == SYN_NODE_ASSIGNMENT) {
+            SymbolSlot slot = statement->left->slot;
+
+            lower_expression(statement->right, slot);
+            program.variable_types[slot] = statement->right->data_type;
+        } else if (statement->type == SYN_NODE_BLOCK) {
+            lower_statements(statement);
+        }
+    }
+}
+
+IrProgram IrLowering::lower() {
+    if (root_tree != nullptr) lower_statements(root_tree);
+
+    return program;
+}
@@ -0,0 +1,59 @@
+/**
+ * Lowering of the checked syntax tree to the three-address intermediate representation
+ * @file: ir_lowering.h
+ * @date: 17.10.2026
+ */
+
+#ifndef SOMA_COMPILER_IR_LOWERING_H
+#define SOMA_COMPILER_IR_LOWERING_H
+
+#include <unordered_map>
+#include <vector>
+#include "ir.h"
+#include "util/types.h"
+
+class SyntaxTree;
+
+class CompilationContext;
+
+/**
+ * Emits the statements in program order, blocks included, since their variables have slots of their own. Every
+ * operator writes a new temporary, except the operator assigned to a variable, which writes the variable directly.
+ */
+class IrLowering {
+private:
+    SyntaxTree *root_tree;
+    IrProgram program;
+    // Temporaries of the lowered nodes, so the nodes shared in a DAG are computed once
+    std::unordered_map<SyntaxTree *, IrRegister> lowered;
+    std::unordered_map<SyntaxTree *, IrRegister> converted;
+    std::vector<IrRegister> operands;
+
+    IrRegister new_temporary();
+
+    IrInstruction &emit(IR_OPCODE opcode, IrRegister dest);
+
+    /**
+     * @return register of the operand, converted to float when the operator needs it
+     */
+    IrRegister operand(SyntaxTree *node, IrRegister operand_register, bool is_float);
+
+    /**
+     * Writes the value of the expression to the destination register
+     */
+    void lower_expression(SyntaxTree *expression, IrRegister dest);
+
+    void lower_statements(SyntaxTree *list);
+
+public:
+    /**
+     * @param variable_count number of slots given out by the semantic analysis
+     */
+    IrLowering(CompilationContext *context, SymbolSlot variable_count);
+
+    ~IrLowering() = default;
+
+    IrProgram lower();
+};
+
+#endif// SOMA_COMPILER_IR_LOWERING_H
@@ -5,140 +5,216 @@
  */
 
 #include "lexical_analysis.h"
+#include "util/character_class.h"
+#include "diagnostics.h"
 #include "util/errors.h"
 
-#include <regex>
-#include <utility>
+LexicalAnalysis::LexicalAnalysis(std::istream *input_stream) : LexicalAnalysis(new SourceBuffer(input_stream)) {
+    owns_source = true;
+}
+
+LexicalAnalysis::LexicalAnalysis(SourceBuffer *source) {
+    this->source = source;
+    this->owns_source = false;
+    this->data = source->get_data();
+    this->length = source->get_length();
+    this->is_too_long = length > LEXICAL_ANALYSIS_MAX_LENGTH;
+    if (is_too_long) this->length = 0;
+    this->position = 0;
+    this->line = 1;
+    this->line_start = 0;
+    this->state = LEX_START_STATE;
+    this->scanner = &CharacterScanner::best();
+    this->diagnostics = nullptr;
+}
 
-LexicalToken::LexicalToken(std::string value, LEXICAL_TOKEN_TYPE type) {
-    this->value = std::move(value);
-    this->type = type;
+LexicalAnalysis::~LexicalAnalysis() {
+    if (owns_source) delete source;
 }
 
-LexicalToken::~LexicalToken() = default;
+SourceBuffer *LexicalAnalysis::get_source() const { return source; }
 
-std::string LexicalToken::get_value() { return value; }
+void LexicalAnalysis::set_scanner(const CharacterScanner *new_scanner) { this->scanner = new_scanner; }
 
-LEXICAL_TOKEN_TYPE LexicalToken::get_type() { return type; }
+void LexicalAnalysis::set_diagnostics(Diagnostics *new_diagnostics) { this->diagnostics = new_diagnostics; }
+
+std::string LexicalAnalysis::get_value(LexicalToken token) const { return {data + token.offset, token.length}; }
+
+LexicalToken LexicalAnalysis::make_token(LEXICAL_TOKEN_TYPE type, size_t offset, size_t token_length) const {
+    return {type, (uint32_t) offset, (uint32_t) token_length, line, (uint32_t) (offset - line_start + 1)};
+}
 
-LexicalAnalysis::LexicalAnalysis(std::istream *input_stream) {
-    this->input_stream = input_stream;
+LexicalToken LexicalAnalysis::error_token(const char *format, size_t token_start, size_t message_end) {
     state = LEX_START_STATE;
+    LexicalToken token = make_token(LEX_TOKEN_ERROR, token_start, position - token_start);
+
+    if (diagnostics != nullptr) {
+        std::string token_value(data + token_start, message_end - token_start);
+        diagnostics->report(LEXICAL_ANALYSIS_ERROR_CODE, token.line, token.column, format, token_value.c_str());
+    }
+
+    return token;
 }
 
-LexicalToken *LexicalAnalysis::get_token() {
-    auto token_value = new std::string();
-    LexicalToken *token;
+LexicalToken LexicalAnalysis::invalid_float(size_t token_start) {
+    // A character that could continue the number belongs to the invalid token, anything else starts the next one and
+    // is left out of the message
+    char c = position <= length ? data[position - 1] : '\0';
+    if (c != '.' && !is_identifier(c)) position--;
+
+    return error_token("Invalid float: %s", token_start, position);
+}
+
+LexicalToken LexicalAnalysis::get_token() {
+    size_t token_start = position;
+
+    if (is_too_long) {
+        is_too_long = false;
+        if (diagnostics != nullptr) {
+            diagnostics->report(LEXICAL_ANALYSIS_ERROR_CODE, 0, 0, "Source is longer than %zu bytes",
+                                LEXICAL_ANALYSIS_MAX_LENGTH);
+        }
+    }
 
     while (true) {
-        char c = (char) input_stream->get();
+        char c = position < length ? data[position] : '\0';
+        position++;
 
         switch (state) {
             case LEX_START_STATE: {
-                std::string char_str = std::string(1, c);
+                token_start = position - 1;
                 switch (c) {
-                    case ' ':
                     case '\n':
+                        line++;
+                        line_start = position;
+                        // fallthrough
+                    case ' ':
                     case '\t':
+                        // Single separators are the common case and not worth a call into the run scanner
+                        if (position < length && is_whitespace(data[position]))
+                            position = scanner->skip_whitespace(data, position, length, &line, &line_start);
                         break;
-                    case EOF:
                     case '\0':
-                        token = new LexicalToken("", LEX_TOKEN_EOF);
-                        return token;
+                        position = token_start;
+                        return make_token(LEX_TOKEN_EOF, token_start, 0);
                     case ';':
-                        token = new LexicalToken(char_str, LEX_TOKEN_SEMICOLON);
-                        return token;
-                    case '+':
-                    case '-':
-                    case '*':
-                    case '/':
-                    case '=':
-                        token_value->push_back(c);
-                        state = LEX_OPERATOR_STATE;
-                        break;
-                    case '(':
-                    case ')':
-                    case '[':
-                    case ']':
-                    case '{':
-                    case '}':
-                        token = new LexicalToken(char_str, brackets.find(char_str)->second);
-                        return token;
+                        return make_token(LEX_TOKEN_SEMICOLON, token_start, 1);
                     default:
-                        if (isdigit(c)) {
-                            token_value->push_back(c);
+                        if (brackets.find(c) != LEX_TOKEN_NONE) {
+                            return make_token(brackets.find(c), token_start, 1);
+                        } else if (operator_characters.find(c) != LEX_TOKEN_NONE) {
+                            state = LEX_OPERATOR_STATE;
+                            break;
+                        } else if (is_digit(c)) {
+                            if (position < length && is_digit(data[position]))
+                                position = scanner->skip_digits(data, position, length);
                             state = LEX_INTEGER_STATE;
                             break;
-                        } else if (isalpha(c)) {
-                            token_value->push_back(c);
+                        } else if (is_alpha(c)) {
+                            if (position < length && is_identifier(data[position]))
+                                position = scanner->skip_identifier(data, position, length);
                             state = LEX_KEYWORD_IDENTIFIER_STATE;
                             break;
                         } else {
-                            throw LexicalAnalysisError("Unexpected character: %c", c);
+                            return error_token("Unexpected character: %s", token_start, position);
                         }
                 }
                 break;
             }
             case LEX_OPERATOR_STATE: {
-                if (c == '+' || c == '-' || c == '*' || c == '/' || c == '=') {
-                    token_value->push_back(c);
-                    break;
-                }
+                if (operator_characters.find(c) != LEX_TOKEN_NONE) break;
 
                 START_FALLBACK
 
-                auto operator_type = operators.find(*token_value);
-                if (operator_type == operators.end())
-                    throw LexicalAnalysisError("Unknown operator: %s", token_value->c_str());
+                auto operator_type = operators.find(data + token_start, position - token_start);
+                if (operator_type == LEX_TOKEN_NONE)
+                    return error_token("Unknown operator: %s", token_start, position);
 
-                token = new LexicalToken(*token_value, operator_type->second);
-                return token;
+                return make_token(operator_type, token_start, position - token_start);
             }
             case LEX_INTEGER_STATE: {
-                if (isdigit(c)) {
-                    token_value->push_back(c);
+                if (is_digit(c)) {
+                    position = scanner->skip_digits(data, position, length);
                     continue;
-                } else if (c == '.' || c == 'e' || c == 'E') {
-                    token_value->push_back(c);
-                    state = LEX_FLOAT_STATE;
+                } else if (c == '.') {
+                    state = LEX_FLOAT_FRACTION_STATE;
                     continue;
+                } else if (c == 'e' || c == 'E') {
+                    state = LEX_FLOAT_EXPONENT_STATE;
+                    continue;
+                }
+
+                START_FALLBACK
+                return make_token(LEX_TOKEN_INTEGER_LITERAL, token_start, position - token_start);
+            }
+            case LEX_FLOAT_FRACTION_STATE: {
+                if (is_digit(c)) {
+                    position = scanner->skip_digits(data, position, length);
+                    continue;
+                } else if (c == 'e' || c == 'E') {
+                    state = LEX_FLOAT_EXPONENT_STATE;
+                    continue;
+                } else if (c == '.') {
+                    return invalid_float(token_start);
                 }
 
                 START_FALLBACK
-                token = new LexicalToken(*token_value, LEX_TOKEN_INTEGER_LITERAL);
-                return token;
+                return make_token(LEX_TOKEN_FLOAT_LITERAL, token_start, position - token_start);
+            }
+            case LEX_FLOAT_EXPONENT_STATE: {
+                if (is_digit(c)) {
+                    state = LEX_FLOAT_EXPONENT_DIGITS_STATE;
+                    continue;
+                } else if (c == '+' || c == '-') {
+                    state = LEX_FLOAT_EXPONENT_SIGN_STATE;
+                    continue;
+                }
+
+                return invalid_float(token_start);
             }
-            case LEX_FLOAT_STATE: {
-                if (isdigit(c) || c == '+' || c == '-' || c == 'e' || c == 'E' || c == '.') {
-                    token_value->push_back(c);
+            case LEX_FLOAT_EXPONENT_SIGN_STATE: {
+                if (is_digit(c)) {
+                    state = LEX_FLOAT_EXPONENT_DIGITS_STATE;
                     continue;
                 }
 
-                if (!std::regex_match(token_value->c_str(),
-                                      std::regex(R"(^(\d+([.]\d*)?([eE][+-]?\d+)?|[.]\d+([eE][+-]?\d+)?)$)"))) {
-                    throw LexicalAnalysisError("Invalid float: %s", token_value->c_str());
+                return invalid_float(token_start);
+            }
+            case LEX_FLOAT_EXPONENT_DIGITS_STATE: {
+                if (is_digit(c)) {
+                    position = scanner->skip_digits(data, position, length);
+                    continue;
+                } else if (c == '.' || c == 'e' || c == 'E') {
+                    return invalid_float(token_start);
                 }
 
                 START_FALLBACK
-                token = new LexicalToken(*token_value, LEX_TOKEN_FLOAT_LITERAL);
-                return token;
+                return make_token(LEX_TOKEN_FLOAT_LITERAL, token_start, position - token_start);
             }
             case LEX_KEYWORD_IDENTIFIER_STATE: {
-                if (isalnum(c) || c == '_') {
-                    token_value->push_back(c);
+                if (is_identifier(c)) {
+                    position = scanner->skip_identifier(data, position, length);
                     continue;
                 }
 
                 START_FALLBACK
 
-                auto keyword = keywords.find(*token_value);
-                token = new LexicalToken(*token_value,
-                                         keyword == keywords.end() ? LEX_TOKEN_IDENTIFIER : keyword->second);
-                return token;
-            }
-            default: {
-                return nullptr;
+                auto keyword = keywords.find(data + token_start, position - token_start);
+                return make_token(keyword == LEX_TOKEN_NONE ? LEX_TOKEN_IDENTIFIER : keyword, token_start,
+                                  position - token_start);
             }
         }
     }
 }
+
+std::vector<LexicalToken> LexicalAnalysis::tokenize() {
+    std::vector<LexicalToken> tokens;
+    // Tokens average a few characters with their separators, longer sources grow the array past the estimate
+    tokens.reserve((length - position) / 4 + 1);
+
+    do {
+        tokens.push_back(get_token());
+    } while (tokens.back().type != LEX_TOKEN_EOF);
+
+    return tokens;
+}
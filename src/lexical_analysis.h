@@ -7,68 +7,144 @@
 #ifndef SOMA_COMPILER_LEXICAL_ANALYSIS_H
 #define SOMA_COMPILER_LEXICAL_ANALYSIS_H
 
+#include <cstddef>
+#include <cstdint>
 #include <fstream>
-#include <map>
 #include <string>
+#include <type_traits>
 #include <vector>
+#include "character_scanner.h"
+#include "source_buffer.h"
+#include "util/perfect_hash.h"
 #include "util/types.h"
 
+class Diagnostics;
+
 #define START_FALLBACK                                                                                                 \
     state = LEX_START_STATE;                                                                                           \
-    input_stream->unget();
+    position--;
 
 typedef enum {
     LEX_START_STATE,
     LEX_OPERATOR_STATE,
     LEX_INTEGER_STATE,
-    LEX_FLOAT_STATE,
+    LEX_FLOAT_FRACTION_STATE,
+    LEX_FLOAT_EXPONENT_STATE,
+    LEX_FLOAT_EXPONENT_SIGN_STATE,
+    LEX_FLOAT_EXPONENT_DIGITS_STATE,
     LEX_KEYWORD_IDENTIFIER_STATE,
 } LEXICAL_ANALYSIS_STATE;
 
-const std::vector<std::string> whitespaces = {" ", "\t", "\n"};
-
-const std::vector<char> end = {'\0', EOF};
-
-const std::map<std::string, LEXICAL_TOKEN_TYPE> brackets = {
+/**
+ * Every fixed lexeme of the language is declared in one of these arrays. The lookup tables below are generated from
+ * them at compile time.
+ */
+constexpr LexemeDefinition bracket_definitions[] = {
         {"(", LEX_TOKEN_LEFT_PARENTHESIS},    {")", LEX_TOKEN_RIGHT_PARENTHESIS},
         {"[", LEX_TOKEN_LEFT_SQUARE_BRACKET}, {"]", LEX_TOKEN_RIGHT_SQUARE_BRACKET},
         {"{", LEX_TOKEN_LEFT_CURLY_BRACKET},  {"}", LEX_TOKEN_RIGHT_CURLY_BRACKET},
 };
 
-const std::map<std::string, LEXICAL_TOKEN_TYPE> operators = {
+constexpr LexemeDefinition operator_definitions[] = {
         {"=", LEX_TOKEN_ASSIGN},   {"+", LEX_TOKEN_PLUS},   {"-", LEX_TOKEN_MINUS},
         {"*", LEX_TOKEN_MULTIPLY}, {"/", LEX_TOKEN_DIVIDE},
 };
 
-const std::map<std::string, LEXICAL_TOKEN_TYPE> keywords = {
+constexpr LexemeDefinition keyword_definitions[] = {
         {"const", LEX_TOKEN_CONST},
         {"var", LEX_TOKEN_VAR},
 };
 
-class LexicalToken {
-private:
-    std::string value;
-    LEXICAL_TOKEN_TYPE type;
+constexpr CharacterLexemeTable brackets(bracket_definitions);
 
-public:
-    LexicalToken(std::string value, LEXICAL_TOKEN_TYPE type);
+constexpr CharacterLexemeTable operator_characters(operator_definitions);
+
+constexpr PerfectHashTable<16, sizeof(operator_definitions) / sizeof(LexemeDefinition)> operators(operator_definitions);
 
-    ~LexicalToken();
+constexpr PerfectHashTable<16, sizeof(keyword_definitions) / sizeof(LexemeDefinition)> keywords(keyword_definitions);
 
-    std::string get_value();
+/**
+ * Token as a slice of the source buffer. Its value is never copied out of the buffer, so tokens are trivially
+ * copyable and a whole file fits into one contiguous array.
+ */
+// Tokens hold 32-bit offsets, longer sources are reported instead of analysed
+#define LEXICAL_ANALYSIS_MAX_LENGTH ((size_t) UINT32_MAX)
 
-    LEXICAL_TOKEN_TYPE get_type();
+struct LexicalToken {
+    LEXICAL_TOKEN_TYPE type;
+    uint32_t offset;
+    uint32_t length;
+    uint32_t line;
+    uint32_t column;
 };
 
+static_assert(std::is_trivially_copyable<LexicalToken>::value, "LexicalToken must stay trivially copyable");
+
 class LexicalAnalysis {
 private:
-    std::istream *input_stream;
+    SourceBuffer *source;
+    bool owns_source;
+    const char *data;
+    size_t length;
+    size_t position;
+    uint32_t line;
+    size_t line_start;
     LEXICAL_ANALYSIS_STATE state;
+    const CharacterScanner *scanner;
+    Diagnostics *diagnostics;
+    // The source is longer than LEXICAL_ANALYSIS_MAX_LENGTH and not reported yet, it is analysed as empty
+    bool is_too_long;
+
+    LexicalToken make_token(LEXICAL_TOKEN_TYPE type, size_t offset, size_t token_length) const;
+
+    /**
+     * Reports the source text from the token start to the message end and returns an error token ending at the
+     * current position
+     */
+    LexicalToken error_token(const char *format, size_t token_start, size_t message_end);
+
+    /**
+     * Rejects a float literal at the character that cannot continue it
+     */
+    LexicalToken invalid_float(size_t token_start);
 
 public:
+    /**
+     * Reads the whole stream into an owned source buffer
+     */
     explicit LexicalAnalysis(std::istream *input_stream);
 
-    LexicalToken *get_token();
+    /**
+     * Runs over a buffer owned by the caller. The buffer must outlive the analysis.
+     */
+    explicit LexicalAnalysis(SourceBuffer *source);
+
+    LexicalAnalysis(const LexicalAnalysis &) = delete;
+
+    LexicalAnalysis &operator=(const LexicalAnalysis &) = delete;
+
+    ~LexicalAnalysis();
+
+    SourceBuffer *get_source() const;
+
+    /**
+     * Overrides the run scanner picked for the running CPU
+     */
+    void set_scanner(const CharacterScanner *new_scanner);
+
+    /**
+     * Invalid input is reported here and produces LEX_TOKEN_ERROR tokens. Without diagnostics it is only skipped.
+     */
+    void set_diagnostics(Diagnostics *new_diagnostics);
+
+    std::string get_value(LexicalToken token) const;
+
+    LexicalToken get_token();
+
+    /**
+     * Scans the rest of the source. The returned array always ends with a LEX_TOKEN_EOF token.
+     */
+    std::vector<LexicalToken> tokenize();
 };
 
 #endif// SOMA_COMPILER_LEXICAL_ANALYSIS_H
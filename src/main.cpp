@@ -1,30 +1,77 @@
-#include <sstream>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <vector>
 
-#include "lexical_analysis.h"
-#include "syntax_analysis.h"
-#include "semantic_analysis.h"
-#include "symbol_table.h"
-#include "optimiser.h"
+#include "driver.h"
 
-extern SymbolTableTree *global_symbol_table;
+static void print_usage(const char *program) {
+    fprintf(stderr, "Usage: %s [-j threads] [-r] [-c] [--cache directory] [--cache-limit megabytes] file...\n",
+            program);
+}
+
+int main(int argc, char **argv) {
+    size_t thread_count = 0;
+    bool print_values = false;
+    DriverOptions options;
+    std::vector<std::string> paths;
+
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "-j") == 0 && i + 1 < argc) {
+            thread_count = strtoul(argv[++i], nullptr, 10);
+        } else if (strncmp(argv[i], "-j", 2) == 0 && argv[i][2] != '\0') {
+            thread_count = strtoul(argv[i] + 2, nullptr, 10);
+        } else if (strcmp(argv[i], "-r") == 0) {
+            print_values = true;
+            options.run_programs = true;
+        } else if (strcmp(argv[i], "-c") == 0) {
+            options.write_artifacts = true;
+        } else if (strcmp(argv[i], "--cache") == 0 && i + 1 < argc) {
+            options.cache_directory = argv[++i];
+        } else if (strcmp(argv[i], "--cache-limit") == 0 && i + 1 < argc) {
+            options.cache_size_limit = strtoull(argv[++i], nullptr, 10) << 20;
+        } else {
+            paths.emplace_back(argv[i]);
+        }
+    }
+
+    if (paths.empty()) {
+        print_usage(argv[0]);
+        return 1;
+    }
 
-int main() {
-    const char *test_input = "const a = 1; var b = 1 + 1; var b = a + b;";
-    std::istringstream input_stream(test_input);
+    Driver driver(thread_count, options);
+    auto results = driver.compile_files(paths);
 
-    auto *analysis = new LexicalAnalysis(&input_stream);
+    int failed = 0;
+    for (auto &result: results) {
+        if (result.success) {
+            printf("%s: ok, %u variables, %zu statements removed, %zu instructions\n", result.path.c_str(),
+                   result.variable_count, result.removed_statements, result.instruction_count);
 
-    auto syntax_analysis = new SyntaxAnalysis(analysis);
-    auto *syntax_tree = syntax_analysis->build_tree();
+            if (print_values) {
+                for (auto &value: result.values)
+                    printf("%s: %s = %s\n", result.path.c_str(), value.first.c_str(), value.second.c_str());
+            }
+            continue;
+        }
 
-    auto *semantic_analysis = new SemanticAnalysis();
-    semantic_analysis->analyze_tree(syntax_tree);
+        failed++;
+        for (auto &diagnostic: result.diagnostics) {
+            if (diagnostic.line == 0) {
+                printf("%s: error: %s\n", result.path.c_str(), diagnostic.message.c_str());
+            } else {
+                printf("%s:%u:%u: error: %s\n", result.path.c_str(), diagnostic.line, diagnostic.column,
+                       diagnostic.message.c_str());
+            }
+        }
 
-    auto *optimiser = new Optimiser(syntax_tree);
-    optimiser->optimize();
+        if (result.dropped_diagnostics > 0)
+            printf("%s: %zu more errors not shown\n", result.path.c_str(), result.dropped_diagnostics);
+    }
 
-    printf("Done\n");
+    printf("Compiled %zu files, %d failed\n", results.size(), failed);
 
-    delete global_symbol_table;
-    return 0;
+    return failed == 0 ? 0 : 1;
 }
@@ -4,79 +4,343 @@
  * @date: 12.12.2022
  */
 
+#include <algorithm>
+#include <cmath>
 #include "optimiser.h"
 #include "syntax_analysis.h"
 #include "semantic_analysis.h"
+#include "compilation_context.h"
+#include "util/small_stack.h"
+
+Optimiser::Optimiser(CompilationContext *context)
+    : root_tree(context->get_syntax_tree()), arena(context->get_arena()) {}
 
 void Optimiser::calculate_expression(SyntaxTree *tree) {
     if (tree == nullptr) return;
-    if (!(tree->type & (SYN_NODE_ADD | SYN_NODE_SUB | SYN_NODE_MUL | SYN_NODE_DIV))) return;
+
+    int index = optimiser_operator_index(tree->type);
+    if (index < 0) return;
 
     auto can_optimize = tree->left && tree->left->type & (SYN_NODE_INTEGER_LITERAL | SYN_NODE_FLOAT_LITERAL) &&
                         tree->right && tree->right->type & (SYN_NODE_INTEGER_LITERAL | SYN_NODE_FLOAT_LITERAL);
 
     if (!can_optimize) return;
 
-    bool is_float = tree->type == SYN_NODE_DIV || tree->left->type == SYN_NODE_FLOAT_LITERAL ||
-                    tree->right->type == SYN_NODE_FLOAT_LITERAL;
+    const OptimiserOperator &op = optimiser_operators[index];
+    SyntaxTree *left = tree->left, *right = tree->right;
+
+    if (op.fold_integer != nullptr && left->type == SYN_NODE_INTEGER_LITERAL &&
+        right->type == SYN_NODE_INTEGER_LITERAL) {
+        tree->type = SYN_NODE_INTEGER_LITERAL;
+        tree->data_type = SYM_TABLE_TYPE_INT;
+        tree->integer_value = op.fold_integer(left->integer_value, right->integer_value);
+    } else {
+        // Mixed operands are computed in double, integers beyond 2^53 round to the nearest double
+        double left_number = left->type == SYN_NODE_FLOAT_LITERAL ? left->float_value : (double) left->integer_value;
+        double right_number =
+                right->type == SYN_NODE_FLOAT_LITERAL ? right->float_value : (double) right->integer_value;
 
-    float left_number = std::stof(*tree->left->value);
-    float right_number = std::stof(*tree->right->value);
-    float result = optimiser_math_map.at(tree->type)(left_number, right_number);
-    int result_int = (int) result;
+        tree->type = SYN_NODE_FLOAT_LITERAL;
+        tree->data_type = SYM_TABLE_TYPE_FLOAT;
+        tree->float_value = op.fold_float(left_number, right_number);
+    }
 
-    tree->type = is_float ? SYN_NODE_FLOAT_LITERAL : SYN_NODE_INTEGER_LITERAL;
-    tree->value = new std::string(is_float ? std::to_string(result) : std::to_string(result_int));
-    delete tree->left;
     tree->left = nullptr;
-    delete tree->right;
     tree->right = nullptr;
 }
 
-void Optimiser::replace_variable_usage() {
-    std::vector<SyntaxTree> replace_trees;
-    SyntaxTree *current_tree = root_tree;
+static bool is_number(const SyntaxTree *tree, int value) {
+    if (tree->type == SYN_NODE_INTEGER_LITERAL) return tree->integer_value == value;
+
+    // Negative zero is not an identity of subtraction
+    return tree->type == SYN_NODE_FLOAT_LITERAL && tree->float_value == value && !std::signbit(tree->float_value);
+}
+
+/**
+ * Expressions have no side effects, so structurally equal trees have equal values
+ */
+static bool same_expression(SyntaxTree *first, SyntaxTree *second) {
+    struct TreePair {
+        SyntaxTree *first;
+        SyntaxTree *second;
+    };
+
+    SmallStack<TreePair, SYN_TREE_TRAVERSAL_INLINE_DEPTH> pairs;
+    pairs.push({first, second});
+
+    while (!pairs.empty()) {
+        SyntaxTree *a = pairs.top().first, *b = pairs.top().second;
+        pairs.pop();
 
-    while (current_tree->left) {
-        if (current_tree->right == current_replace_tree) break;
+        if (a == b) continue;
+        if (a == nullptr || b == nullptr || a->type != b->type) return false;
 
-        if (current_tree->right != current_replace_tree && current_tree->right->type == SYN_NODE_ASSIGNMENT &&
-            *current_tree->right->left->value == *current_replace_tree->left->value) {
-            replace_trees.clear();
+        if (a->type == SYN_NODE_IDENTIFIER) {
+            if (a->slot != b->slot) return false;
+        } else if (a->type == SYN_NODE_INTEGER_LITERAL) {
+            if (a->integer_value != b->integer_value) return false;
+        } else if (a->type == SYN_NODE_FLOAT_LITERAL) {
+            if (a->float_value != b->float_value) return false;
+        } else {
+            pairs.push({a->left, b->left});
+            pairs.push({a->right, b->right});
         }
+    }
+
+    return true;
+}
 
-        replace_trees.push_back(*current_tree);
-        current_tree = current_tree->left;
+static void make_integer(SyntaxTree *tree, int64_t value) {
+    tree->type = SYN_NODE_INTEGER_LITERAL;
+    tree->integer_value = value;
+    tree->left = nullptr;
+    tree->right = nullptr;
+}
+
+/**
+ * Splits an integer chain of the operator into its variable part and its constant. A literal has no variable part,
+ * a chain without a constant on its right has the identity of the operator as constant.
+ * @return true when a constant was split off
+ */
+static bool split_constant(SyntaxTree *tree, SYNTAX_ANALYSIS_NODE_TYPE op, SyntaxTree *&rest, int64_t &constant) {
+    rest = tree;
+    constant = op == SYN_NODE_MUL ? 1 : 0;
+
+    if (tree->type == SYN_NODE_INTEGER_LITERAL) {
+        rest = nullptr;
+        constant = tree->integer_value;
+    } else if (tree->right != nullptr && tree->right->type == SYN_NODE_INTEGER_LITERAL &&
+               (tree->type == op || (op == SYN_NODE_ADD && tree->type == SYN_NODE_SUB))) {
+        rest = tree->left;
+        constant = tree->type == SYN_NODE_SUB ? optimiser_sub(0, tree->right->integer_value)
+                                              : tree->right->integer_value;
+    } else {
+        return false;
     }
 
-    auto replacer = [&](SyntaxTree *tree) {
-        if (tree->type == SYN_NODE_IDENTIFIER && *tree->value == *current_replace_tree->left->value) {
-            tree->type = current_replace_tree->right->type;
-            tree->value = current_replace_tree->right->value;
-        }
-    };
+    return true;
+}
+
+SyntaxTree *Optimiser::integer_node(int64_t value) {
+    auto node = arena->create<SyntaxTree>(SYN_NODE_INTEGER_LITERAL, nullptr);
+    node->integer_value = value;
+    node->data_type = SYM_TABLE_TYPE_INT;
+
+    return node;
+}
+
+void Optimiser::simplify_integer_chain(SyntaxTree *tree) {
+    // A subtraction of a constant joins the addition chain as the addition of its negation
+    SYNTAX_ANALYSIS_NODE_TYPE op = tree->type == SYN_NODE_MUL ? SYN_NODE_MUL : SYN_NODE_ADD;
+    int64_t identity = op == SYN_NODE_MUL ? 1 : 0;
+
+    SyntaxTree *left_rest, *right_rest;
+    int64_t left_constant, right_constant;
+    bool has_constant = split_constant(tree->left, op, left_rest, left_constant);
+
+    if (tree->type == SYN_NODE_SUB) {
+        if (tree->right->type != SYN_NODE_INTEGER_LITERAL) return;
+
+        right_rest = nullptr;
+        right_constant = optimiser_sub(0, tree->right->integer_value);
+        has_constant = true;
+    } else {
+        has_constant |= split_constant(tree->right, op, right_rest, right_constant);
+    }
+
+    if (!has_constant) return;
 
-    for (auto &tree: replace_trees) {
-        auto replacing_tree = tree.right;
+    int64_t constant = optimiser_operators[optimiser_operator_index(op)].fold_integer(left_constant, right_constant);
+    SyntaxTree *rest = left_rest == nullptr ? right_rest : left_rest;
+    if (left_rest != nullptr && right_rest != nullptr) {
+        rest = arena->create<SyntaxTree>(op, left_rest, right_rest);
+        rest->data_type = SYM_TABLE_TYPE_INT;
+    }
+
+    if (rest == nullptr || (op == SYN_NODE_MUL && constant == 0)) {
+        make_integer(tree, rest == nullptr ? constant : 0);
+    } else if (constant == identity) {
+        *tree = *rest;
+    } else {
+        // A literal operand of the tree is free to hold the gathered constant
+        SyntaxTree *literal = tree->right->type == SYN_NODE_INTEGER_LITERAL ? tree->right : integer_node(0);
+
+        // Reads like the source, a - 1 instead of a + -1
+        bool is_subtraction = op == SYN_NODE_ADD && constant < 0 && constant != INT64_MIN;
+        literal->integer_value = is_subtraction ? -constant : constant;
 
-        replacing_tree->process_tree_using(
-                [&](SyntaxTree *_tree) {
-                    if (_tree->type == SYN_NODE_ASSIGNMENT) { _tree->right->process_tree_using(replacer, INORDER); }
-                },
-                POSTORDER);
+        tree->type = is_subtraction ? SYN_NODE_SUB : op;
+        tree->left = rest;
+        tree->right = literal;
     }
 }
 
-void Optimiser::optimize_assignment(SyntaxTree *tree) {
-    tree->right->process_tree_using([&](SyntaxTree *tree) { calculate_expression(tree); }, POSTORDER);
-    current_replace_tree = tree;
-    replace_variable_usage();
+void Optimiser::simplify_expression(SyntaxTree *tree) {
+    if (tree == nullptr || optimiser_operator_index(tree->type) < 0) return;
+
+    SyntaxTree *left = tree->left, *right = tree->right;
+
+    if (tree->data_type == SYM_TABLE_TYPE_INT) {
+        if (tree->type == SYN_NODE_SUB && same_expression(left, right)) {
+            make_integer(tree, 0);
+            return;
+        }
+
+        simplify_integer_chain(tree);
+        return;
+    }
+
+    if (tree->data_type != SYM_TABLE_TYPE_FLOAT) return;
+
+    // Floats are neither associative nor is x + 0, x * 0 or x - x the same for every value, only the operations that
+    // return a float operand unchanged are removed
+    bool keeps_left = left->data_type == SYM_TABLE_TYPE_FLOAT &&
+                      (((tree->type == SYN_NODE_MUL || tree->type == SYN_NODE_DIV) && is_number(right, 1)) ||
+                       (tree->type == SYN_NODE_SUB && is_number(right, 0)));
+    bool keeps_right = right->data_type == SYM_TABLE_TYPE_FLOAT && tree->type == SYN_NODE_MUL && is_number(left, 1);
+
+    if (keeps_left) *tree = *left;
+    else if (keeps_right) *tree = *right;
 }
 
-void Optimiser::optimize() {
-    root_tree->process_tree_using(
+void Optimiser::fold_expression(SyntaxTree *expression) {
+    expression->process_tree_using(
             [&](SyntaxTree *tree) {
-                if (tree->type == SYN_NODE_ASSIGNMENT) { optimize_assignment(tree); }
+                calculate_expression(tree);
+                simplify_expression(tree);
+            },
+            POSTORDER);
+}
+
+SyntaxTree *&Optimiser::known_value(SymbolSlot slot) {
+    if (slot >= known_values.size()) known_values.resize(slot + 1, nullptr);
+
+    return known_values[slot];
+}
+
+void Optimiser::optimize_assignment(SyntaxTree *tree) {
+    // Children are visited first, so a replaced variable is folded into its parent right away
+    tree->right->process_tree_using(
+            [&](SyntaxTree *node) {
+                if (node->type == SYN_NODE_IDENTIFIER) {
+                    SyntaxTree *value = known_value(node->slot);
+                    if (value == nullptr) return;
+
+                    node->type = value->type;
+                    if (value->type == SYN_NODE_INTEGER_LITERAL) node->integer_value = value->integer_value;
+                    else node->float_value = value->float_value;
+                    node->symbol = SYMBOL_ID_NONE;
+                    node->slot = SYMBOL_SLOT_NONE;
+                } else {
+                    calculate_expression(node);
+                    simplify_expression(node);
+                }
             },
             POSTORDER);
+
+    bool is_literal = tree->right->type & (SYN_NODE_INTEGER_LITERAL | SYN_NODE_FLOAT_LITERAL);
+    known_value(tree->left->slot) = is_literal ? tree->right : nullptr;
+}
+
+void Optimiser::optimize_statements(SyntaxTree *list) {
+    // Blocks run in program order as well, and their own declarations have slots of their own
+    for (uint32_t i = 0; i < list->statement_count; i++) {
+        SyntaxTree *statement = list->statements[i];
+
+        if (statement->type == SYN_NODE_ASSIGNMENT) {
+            optimize_assignment(statement);
+        } else if (statement->type == SYN_NODE_BLOCK) {
+            optimize_statements(statement);
+        } else {
+            fold_expression(statement);
+        }
+    }
+}
+
+void Optimiser::optimize() {
+    if (root_tree == nullptr) return;
+
+    known_values.clear();
+    optimize_statements(root_tree);
+}
+
+void Optimiser::reserve_slot(SymbolSlot slot) {
+    if (slot < live_slots.size()) return;
+
+    live_slots.resize(slot + 1, false);
+    next_stores.resize(slot + 1, nullptr);
+    next_store_lists.resize(slot + 1, nullptr);
+}
+
+size_t Optimiser::remove_dead_statements(SyntaxTree *list) {
+    size_t removed = 0;
+    uint32_t first_kept = list->statement_count;
+
+    // Walking backward, a variable is live while a later statement reads it before assigning it again. Kept
+    // statements are packed at the end of the list and moved to its start afterwards.
+    for (uint32_t i = list->statement_count; i-- > 0;) {
+        SyntaxTree *statement = list->statements[i];
+        bool is_dead = true;
+
+        if (statement->type == SYN_NODE_ASSIGNMENT) {
+            SymbolSlot slot = statement->left->slot;
+            reserve_slot(slot);
+            is_dead = !live_slots[slot];
+
+            if (is_dead && statement->attributes & SYN_TREE_ATTR_DECLARATION && next_stores[slot] != nullptr) {
+                // The next store declares the variable instead, unless it is nested in a block of its own scope
+                if (next_store_lists[slot] == list) {
+                    next_stores[slot]->attributes |=
+                            statement->attributes & (SYN_TREE_ATTR_DECLARATION | SYN_TREE_ATTR_CONSTANT);
+                } else {
+                    is_dead = false;
+                }
+            }
+
+            if (!is_dead) {
+                live_slots[slot] = false;
+                next_stores[slot] = statement;
+                next_store_lists[slot] = list;
+
+                statement->right->process_tree_using(
+                        [&](SyntaxTree *tree) {
+                            if (tree->type != SYN_NODE_IDENTIFIER) return;
+
+                            reserve_slot(tree->slot);
+                            live_slots[tree->slot] = true;
+                        },
+                        PREORDER);
+            }
+        } else if (statement->type == SYN_NODE_BLOCK) {
+            removed += remove_dead_statements(statement);
+            is_dead = statement->statement_count == 0;
+        }
+
+        // Expression statements have no effect at all
+        if (is_dead) removed++;
+        else list->statements[--first_kept] = statement;
+    }
+
+    std::copy(list->statements + first_kept, list->statements + list->statement_count, list->statements);
+    list->statement_count -= first_kept;
+
+    return removed;
+}
+
+size_t Optimiser::eliminate_dead_stores() {
+    if (root_tree == nullptr) return 0;
+
+    live_slots.clear();
+    next_stores.clear();
+    next_store_lists.clear();
+
+    for (uint32_t i = 0; i < root_tree->statement_count; i++) {
+        SyntaxTree *statement = root_tree->statements[i];
+        if (statement->type != SYN_NODE_ASSIGNMENT || statement->attributes & SYN_TREE_ATTR_CONSTANT) continue;
+
+        reserve_slot(statement->left->slot);
+        live_slots[statement->left->slot] = true;
+    }
+
+    return remove_dead_statements(root_tree);
 }
@@ -7,38 +7,141 @@
 #ifndef SOMA_COMPILER_OPTIMISER_H
 #define SOMA_COMPILER_OPTIMISER_H
 
-#include <map>
-#include <string>
-#include <functional>
+#include <cstdint>
 #include <vector>
 #include "util/types.h"
 
 class SyntaxTree;
 
-const std::map<SYNTAX_ANALYSIS_NODE_TYPE, const std::function<float(float, float)>> optimiser_math_map = {
-        {SYN_NODE_ADD, std::plus<>()},
-        {SYN_NODE_SUB, std::minus<>()},
-        {SYN_NODE_MUL, std::multiplies<>()},
-        {SYN_NODE_DIV, std::divides<>()},
+class CompilationContext;
+
+class Arena;
+
+// Integer arithmetic wraps around in two's complement instead of overflowing
+constexpr int64_t optimiser_add(int64_t left, int64_t right) { return (int64_t) ((uint64_t) left + (uint64_t) right); }
+
+constexpr int64_t optimiser_sub(int64_t left, int64_t right) { return (int64_t) ((uint64_t) left - (uint64_t) right); }
+
+constexpr int64_t optimiser_mul(int64_t left, int64_t right) { return (int64_t) ((uint64_t) left * (uint64_t) right); }
+
+constexpr double optimiser_add(double left, double right) { return left + right; }
+
+constexpr double optimiser_sub(double left, double right) { return left - right; }
+
+constexpr double optimiser_mul(double left, double right) { return left * right; }
+
+constexpr double optimiser_div(double left, double right) { return left / right; }
+
+/**
+ * Folding of a binary operator. Operators without an integer function always produce a float, like division.
+ */
+struct OptimiserOperator {
+    SYNTAX_ANALYSIS_NODE_TYPE type;
+    int64_t (*fold_integer)(int64_t, int64_t);
+    double (*fold_float)(double, double);
 };
 
+constexpr OptimiserOperator optimiser_operators[] = {
+        {SYN_NODE_ADD, optimiser_add, optimiser_add},
+        {SYN_NODE_SUB, optimiser_sub, optimiser_sub},
+        {SYN_NODE_MUL, optimiser_mul, optimiser_mul},
+        {SYN_NODE_DIV, nullptr, optimiser_div},
+};
+
+/**
+ * @return index of the operator in optimiser_operators, -1 for other node types
+ */
+constexpr int optimiser_operator_index(SYNTAX_ANALYSIS_NODE_TYPE type) {
+    switch (type) {
+        case SYN_NODE_ADD:
+            return 0;
+        case SYN_NODE_SUB:
+            return 1;
+        case SYN_NODE_MUL:
+            return 2;
+        case SYN_NODE_DIV:
+            return 3;
+        default:
+            return -1;
+    }
+}
+
+static_assert(optimiser_operators[optimiser_operator_index(SYN_NODE_ADD)].type == SYN_NODE_ADD &&
+                      optimiser_operators[optimiser_operator_index(SYN_NODE_SUB)].type == SYN_NODE_SUB &&
+                      optimiser_operators[optimiser_operator_index(SYN_NODE_MUL)].type == SYN_NODE_MUL &&
+                      optimiser_operators[optimiser_operator_index(SYN_NODE_DIV)].type == SYN_NODE_DIV,
+              "optimiser_operators must follow optimiser_operator_index");
+
+/**
+ * Folds constant expressions and propagates the values of variables in a single forward pass over the statements.
+ * The program has no control flow, so a variable holds the value of its last assignment until it is reassigned.
+ */
 class Optimiser {
 private:
     SyntaxTree *root_tree;
-    SyntaxTree *current_replace_tree;
+    Arena *arena;
+    // Literal assigned to each slot, nullptr while the value of the slot is not known
+    std::vector<SyntaxTree *> known_values;
+    // Liveness of each slot while walking backward, and its nearest later store that was kept
+    std::vector<uint8_t> live_slots;
+    std::vector<SyntaxTree *> next_stores;
+    std::vector<SyntaxTree *> next_store_lists;
+
+    SyntaxTree *&known_value(SymbolSlot slot);
+
+    SyntaxTree *integer_node(int64_t value);
+
+    /**
+     * Gathers the constants of an integer addition or multiplication chain into a single literal on its right
+     */
+    void simplify_integer_chain(SyntaxTree *tree);
+
+    void optimize_statements(SyntaxTree *list);
+
+    void reserve_slot(SymbolSlot slot);
+
+    /**
+     * @return number of statements removed from the list and its blocks
+     */
+    size_t remove_dead_statements(SyntaxTree *list);
 
 public:
-    Optimiser(SyntaxTree *tree) : root_tree(tree) {}
+    /**
+     * Optimises the syntax tree of the context. Rewritten nodes are allocated in the arena of the context.
+     */
+    explicit Optimiser(CompilationContext *context);
 
     ~Optimiser() = default;
 
-    static void calculate_expression(SyntaxTree *tree);
+    void calculate_expression(SyntaxTree *tree);
+
+    /**
+     * Applies algebraic identities to an operator whose operands are already simplified. Integer chains are
+     * reassociated and commuted, floats only lose operations that return their operand unchanged for every value.
+     */
+    void simplify_expression(SyntaxTree *tree);
 
-    void replace_variable_usage();
+    /**
+     * Folds and simplifies every operator of the expression, its variables are left as they are
+     */
+    void fold_expression(SyntaxTree *expression);
 
+    /**
+     * Replaces the variables with known values in the assigned expression, folds it and records the value of the
+     * assigned variable
+     */
     void optimize_assignment(SyntaxTree *tree);
 
     void optimize();
+
+    /**
+     * Removes the statements whose effect is never observed. The final values of the variables declared with var at
+     * the top level are the result of the program, any other store is dead unless a later statement reads it
+     * before it is overwritten. Constants are not part of the result, so they are removed once every read of them
+     * was replaced by their value.
+     * @return number of statements removed, emptied blocks included
+     */
+    size_t eliminate_dead_stores();
 };
 
 #endif// SOMA_COMPILER_OPTIMISER_H
@@ -4,23 +4,31 @@
  * @date: 13.12.2022
  */
 
+#include <vector>
 #include "util/errors.h"
 #include "symbol_table.h"
 #include "syntax_analysis.h"
 #include "semantic_analysis.h"
-
-extern SymbolTableTree *global_symbol_table;
+#include "compilation_context.h"
+#include "diagnostics.h"
 
 SYM_TABLE_DATA_TYPE SemanticAnalysisUtil::type_checking(SYM_TABLE_DATA_TYPE type1, SYM_TABLE_DATA_TYPE type2) {
     return type1 > type2 ? type1 : type2;
 }
 
-bool SemanticAnalysis::is_defined(std::string *identifier) {
-    if (identifier == nullptr || current_symbol_table == nullptr) return false;
+SemanticAnalysis::SemanticAnalysis(CompilationContext *context)
+    : current_symbol_table(context->get_symbol_table()), diagnostics(context->get_diagnostics()), next_slot(0) {}
+
+void SemanticAnalysis::semantic_error(int code, SyntaxTree *identifier, const char *format) {
+    diagnostics->report(code, identifier->line, identifier->column, format, identifier->value);
+}
+
+bool SemanticAnalysis::is_defined(SymbolId identifier) {
+    if (identifier == SYMBOL_ID_NONE || current_symbol_table == nullptr) return false;
 
     auto token = current_symbol_table->find(identifier);
 
-    return token && token->data->get_flags() & SYM_TABLE_IS_DEFINED;
+    return token && token->data.get_flags() & SYM_TABLE_IS_DEFINED;
 }
 
 SYM_TABLE_DATA_TYPE SemanticAnalysis::get_data_type(SyntaxTree *tree) {
@@ -32,15 +40,15 @@ SYM_TABLE_DATA_TYPE SemanticAnalysis::get_data_type(SyntaxTree *tree) {
         case SYN_NODE_FLOAT_LITERAL:
             return SYM_TABLE_TYPE_FLOAT;
         case SYN_NODE_IDENTIFIER: {
-            auto token = current_symbol_table->find(tree->value);
-            if (token == nullptr) throw SemanticAnalysisOtherError("Undefined identifier: %s", tree->value);
+            // Undefined identifiers are reported when the assignment is resolved
+            auto token = current_symbol_table->find(tree->symbol);
 
-            return token->data->get_type();
+            return token != nullptr ? token->data.get_type() : SYM_TABLE_TYPE_UNKNOWN;
         }
         case SYN_NODE_ADD:
         case SYN_NODE_SUB:
         case SYN_NODE_MUL:
-            return SemanticAnalysisUtil::type_checking(get_data_type(tree->left), get_data_type(tree->right));
+            return SemanticAnalysisUtil::type_checking(tree->left->data_type, tree->right->data_type);
         case SYN_NODE_DIV:
             return SYM_TABLE_TYPE_FLOAT;
         default:
@@ -49,48 +57,78 @@ SYM_TABLE_DATA_TYPE SemanticAnalysis::get_data_type(SyntaxTree *tree) {
 }
 
 void SemanticAnalysis::process_assign(SyntaxTree *tree) {
-    SymbolTableTreeNode *symtable_token;
+    // The value is resolved before the declaration, so a shadowing declaration may use the outer variable
+    tree->right->process_tree_using(
+            [this](SyntaxTree *expression_tree) {
+                if (expression_tree->type == SYN_NODE_IDENTIFIER) {
+                    if (is_defined(expression_tree->symbol)) {
+                        expression_tree->slot = current_symbol_table->find(expression_tree->symbol)->data.get_slot();
+                    } else {
+                        semantic_error(SEMANTIC_ANALYSIS_UNDEFINED_VARIABLE_ERROR_CODE, expression_tree,
+                                       "Variable %s is used before definition");
+                    }
+                }
+
+                // Children are annotated first, so every node computes its type from theirs
+                expression_tree->data_type = get_data_type(expression_tree);
+            },
+            POSTORDER);
+
+    SYM_TABLE_DATA_TYPE type = tree->right->data_type;
+    SymbolTableEntry *symtable_token = current_symbol_table->find(tree->left->symbol);
 
     if (tree->attributes & SYN_TREE_ATTR_DECLARATION) {
-        if (is_defined(tree->left->value))
-            throw SemanticAnalysisRedefineVariableError("Variable %s is already declared", tree->left->value->c_str());
+        // Declarations of outer scopes may be shadowed, only the current scope must not declare a name twice
+        if (is_defined(tree->left->symbol) &&
+            symtable_token->data.get_scope_depth() == current_symbol_table->get_depth()) {
+            semantic_error(SEMANTIC_ANALYSIS_REDEFINE_VARIABLE_ERROR_CODE, tree->left,
+                           "Variable %s is already declared");
+            return;
+        }
 
-        symtable_token = current_symbol_table->insert(tree->left->value);
+        symtable_token = current_symbol_table->declare(tree->left->symbol);
+        symtable_token->data.set_slot(next_slot++);
     } else {
-        symtable_token = current_symbol_table->find(tree->left->value);
-
-        if (symtable_token == nullptr)
-            throw SemanticAnalysisUndefinedVariableError("Variable %s is not declared", tree->left->value->c_str());
+        if (symtable_token == nullptr) {
+            semantic_error(SEMANTIC_ANALYSIS_UNDEFINED_VARIABLE_ERROR_CODE, tree->left, "Variable %s is not declared");
+            return;
+        }
 
-        if (symtable_token->data->get_flags() & SYM_TABLE_IS_CONSTANT)
-            throw SemanticAnalysisReassignConstantError("Variable %s is constant and cannot be reassigned",
-                                                        tree->left->value->c_str());
+        if (symtable_token->data.get_flags() & SYM_TABLE_IS_CONSTANT) {
+            semantic_error(SEMANTIC_ANALYSIS_REASSIGN_CONSTANT_ERROR_CODE, tree->left,
+                           "Variable %s is constant and cannot be reassigned");
+            return;
+        }
     }
 
-    if (tree->attributes & SYN_TREE_ATTR_CONSTANT) symtable_token->data->set_flag(SYM_TABLE_IS_CONSTANT);
+    if (tree->attributes & SYN_TREE_ATTR_CONSTANT) symtable_token->data.set_flag(SYM_TABLE_IS_CONSTANT);
 
-    tree->right->process_tree_using(
-            [this](SyntaxTree *expression_tree) {
-                if (expression_tree->type != SYN_NODE_IDENTIFIER) return;
+    tree->left->slot = symtable_token->data.get_slot();
+    tree->left->data_type = type;
 
-                if (!is_defined(expression_tree->value)) {
-                    throw SemanticAnalysisUndefinedVariableError("Variable %s is used before definition",
-                                                                 expression_tree->value->c_str());
-                }
-            },
-            POSTORDER);
+    symtable_token->data.set_type(type);
 
-    symtable_token->data->set_type(get_data_type(tree->right));
+    symtable_token->data.set_flag(SYM_TABLE_IS_DEFINED);
+}
 
-    symtable_token->data->set_flag(SYM_TABLE_IS_DEFINED);
+void SemanticAnalysis::analyze_statements(SyntaxTree *list) {
+    for (uint32_t i = 0; i < list->statement_count && !diagnostics->is_full(); i++) {
+        SyntaxTree *statement = list->statements[i];
+
+        if (statement->type == SYN_NODE_ASSIGNMENT) {
+            process_assign(statement);
+        } else if (statement->type == SYN_NODE_BLOCK) {
+            current_symbol_table->enter_scope();
+            analyze_statements(statement);
+            current_symbol_table->exit_scope();
+        }
+    }
 }
 
 void SemanticAnalysis::analyze_tree(SyntaxTree *syntax_tree) {
-    current_symbol_table = global_symbol_table;
+    next_slot = 0;
 
-    syntax_tree->process_tree_using(
-            [this](SyntaxTree *tree) {
-                if (tree->type == SYN_NODE_ASSIGNMENT) { process_assign(tree); }
-            },
-            POSTORDER);
+    if (syntax_tree != nullptr) analyze_statements(syntax_tree);
 }
+
+SymbolSlot SemanticAnalysis::get_slot_count() const { return next_slot; }
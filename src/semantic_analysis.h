@@ -7,11 +7,16 @@
 #ifndef SOMA_COMPILER_SEMANTIC_ANALYSIS_H
 #define SOMA_COMPILER_SEMANTIC_ANALYSIS_H
 
+#include "string_interner.h"
 #include "util/types.h"
 
 class SyntaxTree;
 
-class SymbolTableTree;
+class ScopedSymbolTable;
+
+class CompilationContext;
+
+class Diagnostics;
 
 class SemanticAnalysisUtil {
 public:
@@ -20,20 +25,47 @@ public:
 
 class SemanticAnalysis {
 private:
-    SymbolTableTree *current_symbol_table;
+    ScopedSymbolTable *current_symbol_table;
+    Diagnostics *diagnostics;
+    SymbolSlot next_slot;
+
+    /**
+     * Reports an error at the identifier, the format receives the identifier name
+     */
+    void semantic_error(int code, SyntaxTree *identifier, const char *format);
+
+    /**
+     * Analyses the statements of a sequence or block in order. Blocks are analysed in a scope of their own.
+     */
+    void analyze_statements(SyntaxTree *list);
 
 public:
-    SemanticAnalysis() = default;
+    /**
+     * Declarations are made in the symbol table of the context and errors are reported to its diagnostics
+     */
+    explicit SemanticAnalysis(CompilationContext *context);
 
     ~SemanticAnalysis() = default;
 
-    bool is_defined(std::string *identifier);
+    bool is_defined(SymbolId identifier);
 
+    /**
+     * @return type of the node, operators combine the types already annotated on their children
+     */
     SYM_TABLE_DATA_TYPE get_data_type(SyntaxTree *tree);
 
     void process_assign(SyntaxTree *tree);
 
+    /**
+     * Resolves every identifier of the tree to the slot of its declaration. Each declaration gets its own slot, so
+     * shadowing declarations of the same name get different slots.
+     */
     void analyze_tree(SyntaxTree *syntax_tree);
+
+    /**
+     * @return number of slots assigned by the last analysis
+     */
+    SymbolSlot get_slot_count() const;
 };
 
 #endif// SOMA_COMPILER_SEMANTIC_ANALYSIS_H
@@ -0,0 +1,71 @@
+/**
+ * Contiguous source text the lexical analysis runs over
+ * @file: source_buffer.cpp
+ * @date: 17.10.2026
+ */
+
+#include "source_buffer.h"
+
+#include <fstream>
+#include <iterator>
+
+#if defined(__unix__) || defined(__APPLE__)
+#define SOURCE_BUFFER_USE_MMAP
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+SourceBuffer::SourceBuffer(const char *data, size_t length) {
+    this->data = data;
+    this->length = length;
+    this->mapping = nullptr;
+    this->mapping_length = 0;
+}
+
+SourceBuffer::SourceBuffer(std::istream *input_stream) {
+    this->owned_data.assign(std::istreambuf_iterator<char>(*input_stream), std::istreambuf_iterator<char>());
+    this->data = owned_data.data();
+    this->length = owned_data.size();
+    this->mapping = nullptr;
+    this->mapping_length = 0;
+}
+
+SourceBuffer::~SourceBuffer() {
+#ifdef SOURCE_BUFFER_USE_MMAP
+    if (mapping != nullptr) munmap(mapping, mapping_length);
+#endif
+}
+
+SourceBuffer *SourceBuffer::map_file(const char *path) {
+#ifdef SOURCE_BUFFER_USE_MMAP
+    int fd = open(path, O_RDONLY);
+    if (fd < 0) return nullptr;
+
+    struct stat file_stat {};
+    if (fstat(fd, &file_stat) == 0 && file_stat.st_size > 0) {
+        auto size = (size_t) file_stat.st_size;
+        void *mapped = mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0);
+        close(fd);
+
+        if (mapped != MAP_FAILED) {
+            auto buffer = new SourceBuffer((const char *) mapped, size);
+            buffer->mapping = mapped;
+            buffer->mapping_length = size;
+            return buffer;
+        }
+    } else {
+        close(fd);
+    }
+#endif
+
+    std::ifstream file_stream(path, std::ios::binary);
+    if (!file_stream.is_open()) return nullptr;
+
+    return new SourceBuffer(&file_stream);
+}
+
+const char *SourceBuffer::get_data() const { return data; }
+
+size_t SourceBuffer::get_length() const { return length; }
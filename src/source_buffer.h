@@ -0,0 +1,50 @@
+/**
+ * Contiguous source text the lexical analysis runs over
+ * @file: source_buffer.h
+ * @date: 17.10.2026
+ */
+
+#ifndef SOMA_COMPILER_SOURCE_BUFFER_H
+#define SOMA_COMPILER_SOURCE_BUFFER_H
+
+#include <cstddef>
+#include <istream>
+#include <string>
+
+class SourceBuffer {
+private:
+    const char *data;
+    size_t length;
+    std::string owned_data;
+    void *mapping;
+    size_t mapping_length;
+
+public:
+    /**
+     * Creates a view over memory owned by the caller. The memory must outlive the buffer.
+     */
+    SourceBuffer(const char *data, size_t length);
+
+    /**
+     * Reads the whole stream into a buffer owned by this object
+     */
+    explicit SourceBuffer(std::istream *input_stream);
+
+    SourceBuffer(const SourceBuffer &) = delete;
+
+    SourceBuffer &operator=(const SourceBuffer &) = delete;
+
+    ~SourceBuffer();
+
+    /**
+     * Maps a file into memory. Falls back to reading it when mapping is not available.
+     * @return nullptr when the file cannot be opened
+     */
+    static SourceBuffer *map_file(const char *path);
+
+    const char *get_data() const;
+
+    size_t get_length() const;
+};
+
+#endif// SOMA_COMPILER_SOURCE_BUFFER_H
@@ -0,0 +1,70 @@
+/**
+ * String interning of identifiers
+ * @file: string_interner.cpp
+ * @date: 17.10.2026
+ */
+
+#include "string_interner.h"
+#include "util/hash.h"
+
+#include <cstring>
+
+#define STRING_INTERNER_INITIAL_SLOTS 64
+
+StringInterner::StringInterner() : storage(4096), strings(), slots(STRING_INTERNER_INITIAL_SLOTS, SYMBOL_ID_NONE) {}
+
+size_t StringInterner::find_slot(const char *text, size_t length, uint32_t hash) const {
+    size_t mask = slots.size() - 1;
+    size_t slot = hash & mask;
+
+    while (slots[slot] != SYMBOL_ID_NONE) {
+        const InternedString &candidate = strings[slots[slot]];
+
+        if (candidate.hash == hash && candidate.length == length && memcmp(candidate.text, text, length) == 0)
+            return slot;
+
+        slot = (slot + 1) & mask;
+    }
+
+    return slot;
+}
+
+void StringInterner::grow() {
+    std::vector<SymbolId> new_slots(slots.size() * 2, SYMBOL_ID_NONE);
+    size_t mask = new_slots.size() - 1;
+
+    for (SymbolId id = 0; id < strings.size(); id++) {
+        size_t slot = strings[id].hash & mask;
+        while (new_slots[slot] != SYMBOL_ID_NONE) slot = (slot + 1) & mask;
+
+        new_slots[slot] = id;
+    }
+
+    slots.swap(new_slots);
+}
+
+SymbolId StringInterner::intern(const char *text, size_t length) {
+    uint32_t hash = fnv1a_hash(text, length);
+    size_t slot = find_slot(text, length, hash);
+
+    if (slots[slot] != SYMBOL_ID_NONE) return slots[slot];
+
+    auto id = (SymbolId) strings.size();
+    strings.push_back({storage.copy_string(text, length), (uint32_t) length, hash});
+    slots[slot] = id;
+
+    // Keep the load factor at most one half so probe sequences stay short
+    if (strings.size() * 2 > slots.size()) grow();
+
+    return id;
+}
+
+SymbolId StringInterner::find(const char *text, size_t length) const {
+    return slots[find_slot(text, length, fnv1a_hash(text, length))];
+}
+
+const char *StringInterner::get_text(SymbolId id) const { return strings[id].text; }
+
+size_t StringInterner::get_length(SymbolId id) const { return strings[id].length; }
+
+size_t StringInterner::size() const { return strings.size(); }
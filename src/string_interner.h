@@ -0,0 +1,66 @@
+/**
+ * String interning of identifiers
+ * @file: string_interner.h
+ * @date: 17.10.2026
+ */
+
+#ifndef SOMA_COMPILER_STRING_INTERNER_H
+#define SOMA_COMPILER_STRING_INTERNER_H
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+#include "util/arena.h"
+
+typedef uint32_t SymbolId;
+
+#define SYMBOL_ID_NONE ((SymbolId) -1)
+
+/**
+ * Stores every distinct string once and identifies it by a dense integer. Two identifiers are equal exactly when
+ * their ids are equal. Texts stay valid and at the same address until the interner is destroyed.
+ */
+class StringInterner {
+private:
+    struct InternedString {
+        const char *text;
+        uint32_t length;
+        uint32_t hash;
+    };
+
+    Arena storage;
+    std::vector<InternedString> strings;
+    std::vector<SymbolId> slots;
+
+    size_t find_slot(const char *text, size_t length, uint32_t hash) const;
+
+    void grow();
+
+public:
+    StringInterner();
+
+    StringInterner(const StringInterner &) = delete;
+
+    StringInterner &operator=(const StringInterner &) = delete;
+
+    /**
+     * @return id of the string, adding it when it was not interned yet
+     */
+    SymbolId intern(const char *text, size_t length);
+
+    /**
+     * @return id of the string or SYMBOL_ID_NONE when it was never interned
+     */
+    SymbolId find(const char *text, size_t length) const;
+
+    /**
+     * @return '\0' terminated text of the id
+     */
+    const char *get_text(SymbolId id) const;
+
+    size_t get_length(SymbolId id) const;
+
+    size_t size() const;
+};
+
+#endif// SOMA_COMPILER_STRING_INTERNER_H
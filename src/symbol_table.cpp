@@ -1,132 +1,152 @@
 /**
- * Symbol table implementation using BST
+ * Symbol table implementation using an open addressing hash table
  * @file: symbol_table.cpp
  * @date: 13.12.2022
  */
 
 #include "symbol_table.h"
 
-#include <utility>
+#define SYM_TABLE_INITIAL_BITS 4
 
-auto *global_symbol_table = new SymbolTableTree();
+SymbolTableData::SymbolTableData()
+    : type(SYM_TABLE_TYPE_UNKNOWN), flags(SYM_TABLE_NO_FLAG), scope_depth(0), slot(SYMBOL_SLOT_NONE) {}
 
-SymbolTableTreeNode::SymbolTableTreeNode(std::string *key) {
-    this->key = key;
-    this->data = new SymbolTableTreeData();
-    this->left = nullptr;
-    this->right = nullptr;
-}
+void SymbolTableData::set_flag(SYM_TABLE_NODE_FLAG flag) { this->flags |= flag; }
 
-SymbolTableTreeNode::~SymbolTableTreeNode() {
-    delete this->key;
-    delete this->data;
-    delete this->left;
-    delete this->right;
-}
+void SymbolTableData::unset_flag(SYM_TABLE_NODE_FLAG flag) { this->flags &= ~flag; }
 
-void SymbolTableTreeData::set_flag(SYM_TABLE_NODE_FLAG flag) { this->flags |= flag; }
+void SymbolTableData::set_type(SYM_TABLE_DATA_TYPE new_type) { this->type = new_type; }
 
-void SymbolTableTreeData::unset_flag(SYM_TABLE_NODE_FLAG flag) { this->flags &= ~flag; }
+SYM_TABLE_DATA_TYPE SymbolTableData::get_type() const { return this->type; }
 
-void SymbolTableTreeData::set_type(SYM_TABLE_DATA_TYPE new_type) { this->type = new_type; }
+SYM_TABLE_NODE_FLAG SymbolTableData::get_flags() const { return this->flags; }
 
-SYM_TABLE_DATA_TYPE SymbolTableTreeData::get_type() const { return this->type; }
+void SymbolTableData::set_scope_depth(uint32_t depth) { this->scope_depth = depth; }
 
-SYM_TABLE_NODE_FLAG SymbolTableTreeData::get_flags() const { return this->flags; }
+uint32_t SymbolTableData::get_scope_depth() const { return this->scope_depth; }
 
-SYN_TABLE_COMPARATOR_FLAG SymbolTableTree::comparator(std::string *a, std::string *b) {
-    return *a == *b ? SYN_TABLE_COMP_OP_EQ : *a < *b ? SYN_TABLE_COMP_OP_LT : SYN_TABLE_COMP_OP_GT;
-}
+void SymbolTableData::set_slot(SymbolSlot new_slot) { this->slot = new_slot; }
+
+SymbolSlot SymbolTableData::get_slot() const { return this->slot; }
 
-SymbolTableTree::~SymbolTableTree() {
-    delete this->root;
-    this->root = nullptr;
+SymbolTable::SymbolTable()
+    : entries((size_t) 1 << SYM_TABLE_INITIAL_BITS, SymbolTableEntry{SYMBOL_ID_NONE, SymbolTableData()}), count(0),
+      shift(32 - SYM_TABLE_INITIAL_BITS) {}
+
+size_t SymbolTable::home_slot(SymbolId key) const {
+    // Fibonacci hashing spreads the dense, sequential ids handed out by the interner
+    return (size_t) ((uint32_t) (key * 2654435769u) >> shift);
 }
 
-SymbolTableTreeNode *SymbolTableTree::find(std::string *search_key, SymbolTableTreeNode *node) {
-    if (node == nullptr) return nullptr;
+void SymbolTable::grow() {
+    std::vector<SymbolTableEntry> old_entries(entries.size() * 2, SymbolTableEntry{SYMBOL_ID_NONE, SymbolTableData()});
+    old_entries.swap(entries);
+    shift--;
+
+    size_t mask = entries.size() - 1;
+    for (auto &entry: old_entries) {
+        if (entry.key == SYMBOL_ID_NONE) continue;
 
-    auto comp = comparator(search_key, node->key);
+        size_t slot = home_slot(entry.key);
+        while (entries[slot].key != SYMBOL_ID_NONE) slot = (slot + 1) & mask;
 
-    if (comp == SYN_TABLE_COMP_OP_EQ) {
-        return node;
-    } else if (comp == SYN_TABLE_COMP_OP_LT) {
-        return find(search_key, node->left);
-    } else {
-        return find(search_key, node->right);
+        entries[slot] = entry;
     }
 }
 
-SymbolTableTreeNode *SymbolTableTree::find(std::string *search_key) {
-    if (this->root == nullptr) return nullptr;
+SymbolTableEntry *SymbolTable::find(SymbolId search_key) {
+    size_t mask = entries.size() - 1;
 
-    return find(search_key, root);
+    for (size_t slot = home_slot(search_key);; slot = (slot + 1) & mask) {
+        if (entries[slot].key == search_key) return &entries[slot];
+        if (entries[slot].key == SYMBOL_ID_NONE) return nullptr;
+    }
 }
 
-SymbolTableTreeNode *SymbolTableTree::insert(std::string *insert_key, SymbolTableTreeNode *node) {
-    auto comp = comparator(insert_key, node->key);
-
-    if (comp == SYN_TABLE_COMP_OP_EQ) {
-        return node;
-    } else if (comp == SYN_TABLE_COMP_OP_LT) {
-        if (node->left == nullptr) {
-            node->left = new SymbolTableTreeNode(insert_key);
-            return node->left;
-        } else {
-            return insert(insert_key, node->left);
-        }
-    } else {
-        if (node->right == nullptr) {
-            node->right = new SymbolTableTreeNode(insert_key);
-            return node->right;
-        } else {
-            return insert(insert_key, node->right);
-        }
+SymbolTableEntry *SymbolTable::insert(SymbolId insert_key) {
+    // Keep the load factor below 0.7 so that probe sequences stay short
+    if ((count + 1) * 10 > entries.size() * 7) grow();
+
+    size_t mask = entries.size() - 1;
+    size_t slot = home_slot(insert_key);
+
+    while (entries[slot].key != SYMBOL_ID_NONE) {
+        if (entries[slot].key == insert_key) return &entries[slot];
+
+        slot = (slot + 1) & mask;
     }
+
+    entries[slot] = SymbolTableEntry{insert_key, SymbolTableData()};
+    count++;
+
+    return &entries[slot];
 }
 
-SymbolTableTreeNode *SymbolTableTree::insert(std::string *insert_key) {
-    if (this->root == nullptr) {
-        this->root = new SymbolTableTreeNode(insert_key);
-        return this->root;
+void SymbolTable::remove(SymbolId remove_key) {
+    SymbolTableEntry *entry = find(remove_key);
+    if (entry == nullptr) return;
+
+    size_t mask = entries.size() - 1;
+    size_t hole = entry - entries.data();
+
+    // Shift back every following entry of the cluster whose home slot does not lie between the hole and itself
+    for (size_t slot = (hole + 1) & mask; entries[slot].key != SYMBOL_ID_NONE; slot = (slot + 1) & mask) {
+        size_t home = home_slot(entries[slot].key);
+        bool stays = hole <= slot ? hole < home && home <= slot : hole < home || home <= slot;
+
+        if (!stays) {
+            entries[hole] = entries[slot];
+            hole = slot;
+        }
     }
 
-    return insert(insert_key, this->root);
+    entries[hole].key = SYMBOL_ID_NONE;
+    count--;
 }
 
-void SymbolTableTree::remove(std::string *remove_key, SymbolTableTreeNode *node) {
-    auto comp = comparator(remove_key, node->key);
-
-    if (comp == SYN_TABLE_COMP_OP_EQ) {
-        if (node->left == nullptr && node->right == nullptr) {
-            delete node;
-        } else if (node->left == nullptr || node->right == nullptr) {
-            node->key = node->right->key;
-            node->data = node->right->data;
-            node->left = node->right->left;
-            node->right = node->right->right;
-        } else {
-            auto replacement = node->right;
-
-            while (replacement->left != nullptr) replacement = replacement->left;
-
-            node->key = replacement->key;
-            node->data = replacement->data;
-            node->right = replacement->right;
-        }
-    } else if (comp == SYN_TABLE_COMP_OP_LT) {
-        if (node->left == nullptr) return;
+size_t SymbolTable::size() const { return count; }
+
+void ScopedSymbolTable::enter_scope() { scope_starts.push_back(undo_log.size()); }
 
-        return remove(remove_key, node->left);
-    } else {
-        if (node->right == nullptr) return;
+void ScopedSymbolTable::exit_scope() {
+    if (scope_starts.empty()) return;
 
-        return remove(remove_key, node->right);
+    size_t scope_start = scope_starts.back();
+    scope_starts.pop_back();
+
+    // Undo in reverse order, so a name declared twice in the scope ends up with the data from before the scope
+    while (undo_log.size() > scope_start) {
+        auto &shadowed = undo_log.back();
+
+        if (shadowed.was_present) table.find(shadowed.key)->data = shadowed.previous;
+        else table.remove(shadowed.key);
+
+        undo_log.pop_back();
     }
 }
 
-void SymbolTableTree::remove(std::string *insert_key) {
-    if (this->root == nullptr) return;
+uint32_t ScopedSymbolTable::get_depth() const { return (uint32_t) scope_starts.size(); }
+
+SymbolTableEntry *ScopedSymbolTable::find(SymbolId search_key) { return table.find(search_key); }
 
-    return remove(insert_key, this->root);
+SymbolTableEntry *ScopedSymbolTable::declare(SymbolId declare_key) {
+    // Global declarations are never undone, so they need no log entry
+    if (!scope_starts.empty()) {
+        SymbolTableEntry *existing = table.find(declare_key);
+
+        if (existing != nullptr) undo_log.push_back(ShadowedEntry{declare_key, true, existing->data});
+        else undo_log.push_back(ShadowedEntry{declare_key, false, SymbolTableData()});
+    }
+
+    SymbolTableEntry *entry = table.insert(declare_key);
+    entry->data = SymbolTableData();
+    entry->data.set_scope_depth(get_depth());
+
+    return entry;
 }
+
+void ScopedSymbolTable::remove(SymbolId remove_key) {
+    if (scope_starts.empty()) table.remove(remove_key);
+}
+
+size_t ScopedSymbolTable::size() const { return table.size(); }
@@ -1,5 +1,5 @@
 /**
- * Symbol table implementation using BST
+ * Symbol table implementation using an open addressing hash table
  * @file: symbol_table.h
  * @date: 13.12.2022
  */
@@ -7,26 +7,31 @@
 #ifndef SOMA_COMPILER_SYMBOL_TABLE_H
 #define SOMA_COMPILER_SYMBOL_TABLE_H
 
-#include <string>
+#include <cstddef>
+#include <vector>
+#include "string_interner.h"
 #include "util/enum.h"
 #include "util/types.h"
 
 ENUM_BIT_CASTING(SYM_TABLE_DATA_TYPE)
 
 typedef enum {
+    SYM_TABLE_NO_FLAG = 0x00,
     SYM_TABLE_IS_DEFINED = 0x01,
     SYM_TABLE_IS_CONSTANT = 0x02,
 } SYM_TABLE_NODE_FLAG;
 
 ENUM_BIT_CASTING(SYM_TABLE_NODE_FLAG)
 
-class SymbolTableTreeData {
+class SymbolTableData {
 private:
     SYM_TABLE_DATA_TYPE type;
     SYM_TABLE_NODE_FLAG flags;
+    uint32_t scope_depth;
+    SymbolSlot slot;
 
 public:
-    SymbolTableTreeData() = default;
+    SymbolTableData();
 
     void set_flag(SYM_TABLE_NODE_FLAG flag);
 
@@ -37,46 +42,101 @@ public:
     SYM_TABLE_DATA_TYPE get_type() const;
 
     SYM_TABLE_NODE_FLAG get_flags() const;
+
+    void set_scope_depth(uint32_t depth);
+
+    uint32_t get_scope_depth() const;
+
+    void set_slot(SymbolSlot new_slot);
+
+    SymbolSlot get_slot() const;
 };
 
-typedef enum {
-    SYN_TABLE_COMP_OP_EQ,
-    SYN_TABLE_COMP_OP_LT,
-    SYN_TABLE_COMP_OP_GT,
-} SYN_TABLE_COMPARATOR_FLAG;
+class SymbolTableEntry {
+public:
+    SymbolId key;
+    SymbolTableData data;
+};
+
+/**
+ * Linear probing hash table storing keys and data inline. Removal shifts the following entries back instead of
+ * leaving tombstones. Entry pointers are invalidated by insert and remove.
+ */
+class SymbolTable {
+private:
+    std::vector<SymbolTableEntry> entries;
+    size_t count;
+    unsigned int shift;
+
+    size_t home_slot(SymbolId key) const;
+
+    void grow();
 
-class SymbolTableTreeNode {
 public:
-    std::string *key;
-    SymbolTableTreeData *data;
-    SymbolTableTreeNode *left;
-    SymbolTableTreeNode *right;
+    SymbolTable();
+
+    ~SymbolTable() = default;
 
-    explicit SymbolTableTreeNode(std::string *key);
+    SymbolTableEntry *find(SymbolId search_key);
 
-    ~SymbolTableTreeNode();
+    /**
+     * @return entry of the key, created with default data when the key was not present
+     */
+    SymbolTableEntry *insert(SymbolId insert_key);
+
+    void remove(SymbolId remove_key);
+
+    size_t size() const;
 };
 
-class SymbolTableTree {
+/**
+ * Symbol table with nested scopes. All visible names live in a single hash table, so lookups cost the same at any
+ * nesting depth. A declaration that shadows an outer one saves the outer data in an undo log, and leaving a scope
+ * replays only the log entries of that scope.
+ */
+class ScopedSymbolTable {
 private:
-    SymbolTableTreeNode *root = nullptr;
+    struct ShadowedEntry {
+        SymbolId key;
+        bool was_present;
+        SymbolTableData previous;
+    };
 
-    static SYN_TABLE_COMPARATOR_FLAG comparator(std::string *a, std::string *b);
+    SymbolTable table;
+    std::vector<ShadowedEntry> undo_log;
+    std::vector<size_t> scope_starts;
 
-    SymbolTableTreeNode *find(std::string *search_key, SymbolTableTreeNode *node);
+public:
+    ScopedSymbolTable() = default;
 
-    SymbolTableTreeNode *insert(std::string *insert_key, SymbolTableTreeNode *node);
+    ~ScopedSymbolTable() = default;
 
-    void remove(std::string *remove_key, SymbolTableTreeNode *node);
+    void enter_scope();
 
-public:
-    ~SymbolTableTree();
+    /**
+     * Restores the names shadowed by the declarations of the innermost scope. Does nothing in the global scope.
+     */
+    void exit_scope();
+
+    /**
+     * @return number of open scopes, 0 in the global scope
+     */
+    uint32_t get_depth() const;
+
+    SymbolTableEntry *find(SymbolId search_key);
 
-    SymbolTableTreeNode *find(std::string *search_key);
+    /**
+     * Declares the key in the current scope, shadowing any visible declaration of it
+     * @return entry of the key with default data and the current scope depth
+     */
+    SymbolTableEntry *declare(SymbolId declare_key);
 
-    SymbolTableTreeNode *insert(std::string *insert_key);
+    /**
+     * Removes a declaration of the global scope. Does nothing while a scope is open, as leaving it may restore the key.
+     */
+    void remove(SymbolId remove_key);
 
-    void remove(std::string *remove_key);
+    size_t size() const;
 };
 
 #endif// SOMA_COMPILER_SYMBOL_TABLE_H
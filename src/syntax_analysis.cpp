@@ -4,16 +4,27 @@
  * @date: 12.12.2022
  */
 
+#include <algorithm>
+#include <cstdlib>
 #include "syntax_analysis.h"
 #include "lexical_analysis.h"
+#include "compilation_context.h"
+#include "diagnostics.h"
 #include "util/errors.h"
+#include "util/number_format.h"
 
-std::map<LEXICAL_TOKEN_TYPE, SyntaxAnalysisAttribute> attributes = {
+const std::map<LEXICAL_TOKEN_TYPE, SyntaxAnalysisAttribute> attributes = {
         {LEX_TOKEN_EOF, SyntaxAnalysisAttribute("EOF", false, false, -1, (SYNTAX_ANALYSIS_NODE_TYPE) -1)},
         {LEX_TOKEN_SEMICOLON, SyntaxAnalysisAttribute(";", false, false, -1, (SYNTAX_ANALYSIS_NODE_TYPE) -1)},
+        {LEX_TOKEN_ERROR, SyntaxAnalysisAttribute("ERROR", false, false, -1, (SYNTAX_ANALYSIS_NODE_TYPE) -1)},
         {LEX_TOKEN_IDENTIFIER, SyntaxAnalysisAttribute("ID", false, false, -1, SYN_NODE_IDENTIFIER)},
         {LEX_TOKEN_LEFT_PARENTHESIS, SyntaxAnalysisAttribute("(", false, false, -1, (SYNTAX_ANALYSIS_NODE_TYPE) -1)},
         {LEX_TOKEN_RIGHT_PARENTHESIS, SyntaxAnalysisAttribute(")", false, false, -1, (SYNTAX_ANALYSIS_NODE_TYPE) -1)},
+        {LEX_TOKEN_LEFT_SQUARE_BRACKET, SyntaxAnalysisAttribute("[", false, false, -1, (SYNTAX_ANALYSIS_NODE_TYPE) -1)},
+        {LEX_TOKEN_RIGHT_SQUARE_BRACKET,
+         SyntaxAnalysisAttribute("]", false, false, -1, (SYNTAX_ANALYSIS_NODE_TYPE) -1)},
+        {LEX_TOKEN_LEFT_CURLY_BRACKET, SyntaxAnalysisAttribute("{", false, false, -1, SYN_NODE_BLOCK)},
+        {LEX_TOKEN_RIGHT_CURLY_BRACKET, SyntaxAnalysisAttribute("}", false, false, -1, (SYNTAX_ANALYSIS_NODE_TYPE) -1)},
         {LEX_TOKEN_ASSIGN, SyntaxAnalysisAttribute("=", false, false, -1, SYN_NODE_ASSIGNMENT)},
         {LEX_TOKEN_PLUS, SyntaxAnalysisAttribute("+", true, true, 7, SYN_NODE_ADD)},
         {LEX_TOKEN_MINUS, SyntaxAnalysisAttribute("-", true, true, 7, SYN_NODE_SUB)},
@@ -45,98 +56,228 @@ int SyntaxAnalysisAttribute::get_precedence() const { return precedence; }
 
 SYNTAX_ANALYSIS_NODE_TYPE SyntaxAnalysisAttribute::get_type() const { return type; }
 
-SyntaxTree::SyntaxTree(SYNTAX_ANALYSIS_NODE_TYPE type, std::string *value) {
+SyntaxTree::SyntaxTree(SYNTAX_ANALYSIS_NODE_TYPE type, const char *value) {
     this->type = type;
+    this->statement_count = 0;
     this->value = value;
+    this->symbol = SYMBOL_ID_NONE;
+    this->slot = SYMBOL_SLOT_NONE;
     this->left = nullptr;
     this->right = nullptr;
     this->attributes = SYN_TREE_ATTR_NONE;
+    this->data_type = SYM_TABLE_TYPE_UNKNOWN;
+    this->line = 0;
+    this->column = 0;
+}
+
+std::string SyntaxTree::get_text() const {
+    if (type == SYN_NODE_IDENTIFIER) return value;
+    if (type == SYN_NODE_INTEGER_LITERAL) return std::to_string(integer_value);
+    if (type == SYN_NODE_FLOAT_LITERAL) return format_double(float_value);
+
+    return "";
 }
 
 SyntaxTree::SyntaxTree(SYNTAX_ANALYSIS_NODE_TYPE type, SyntaxTree *left, SyntaxTree *right) {
     this->type = type;
+    this->statement_count = 0;
     this->value = nullptr;
+    this->symbol = SYMBOL_ID_NONE;
+    this->slot = SYMBOL_SLOT_NONE;
     this->left = left;
     this->right = right;
     this->attributes = SYN_TREE_ATTR_NONE;
+    this->data_type = SYM_TABLE_TYPE_UNKNOWN;
+    this->line = 0;
+    this->column = 0;
+}
+
+SyntaxTree::SyntaxTree(SYNTAX_ANALYSIS_NODE_TYPE type, SyntaxTree **statements, uint32_t statement_count) {
+    this->type = type;
+    this->statement_count = statement_count;
+    this->statements = statements;
+    this->symbol = SYMBOL_ID_NONE;
+    this->slot = SYMBOL_SLOT_NONE;
+    this->left = nullptr;
+    this->right = nullptr;
+    this->attributes = SYN_TREE_ATTR_NONE;
+    this->data_type = SYM_TABLE_TYPE_UNKNOWN;
+    this->line = 0;
+    this->column = 0;
+}
+
+SyntaxAnalysis::SyntaxAnalysis(LexicalAnalysis *lexical_analysis, CompilationContext *context)
+    : lexical_analysis(lexical_analysis), context(context), arena(context->get_arena()),
+      interner(context->get_interner()), diagnostics(context->get_diagnostics()), token_index(0), current_token(),
+      block_depth(0), recovering(false) {
+    lexical_analysis->set_diagnostics(diagnostics);
+}
+
+LexicalToken SyntaxAnalysis::peek_token(size_t distance) const {
+    size_t index = token_index + distance;
+
+    return index < tokens.size() ? tokens[index] : tokens.back();
+}
+
+std::string SyntaxAnalysis::token_value(LexicalToken token) const { return lexical_analysis->get_value(token); }
+
+SyntaxTree *SyntaxAnalysis::literal_node() {
+    const char *text = lexical_analysis->get_source()->get_data() + current_token.offset;
+    auto node = token_node(attributes.at(current_token.type).get_type(), nullptr);
+
+    if (node->type == SYN_NODE_INTEGER_LITERAL) {
+        uint64_t number = 0;
+        for (uint32_t i = 0; i < current_token.length; i++) {
+            auto digit = (uint64_t) (text[i] - '0');
+            if (number > ((uint64_t) INT64_MAX - digit) / 10) {
+                syntax_error("Integer literal out of range: %s", token_value(current_token).c_str());
+                return nullptr;
+            }
+
+            number = number * 10 + digit;
+        }
+
+        node->integer_value = (int64_t) number;
+        node->data_type = SYM_TABLE_TYPE_INT;
+    } else {
+        // The token is not terminated in the source buffer, strtod needs a terminated copy
+        std::string literal(text, current_token.length);
+        node->float_value = std::strtod(literal.c_str(), nullptr);
+        node->data_type = SYM_TABLE_TYPE_FLOAT;
+    }
+
+    return node;
+}
+
+SyntaxTree *SyntaxAnalysis::token_node(SYNTAX_ANALYSIS_NODE_TYPE type, const char *value) {
+    auto node = arena->create<SyntaxTree>(type, value);
+    node->line = current_token.line;
+    node->column = current_token.column;
+
+    return node;
+}
+
+SyntaxTree *SyntaxAnalysis::identifier_node() {
+    SymbolId symbol =
+            interner->intern(lexical_analysis->get_source()->get_data() + current_token.offset, current_token.length);
+
+    auto node = token_node(SYN_NODE_IDENTIFIER, interner->get_text(symbol));
+    node->symbol = symbol;
+
+    return node;
 }
 
-#pragma clang diagnostic push
-#pragma ide diagnostic ignored "misc-no-recursion"
-void SyntaxTree::process_tree_using(const std::function<void(SyntaxTree *)> &function, TRAVERSAL_TYPE traversal_type) {
-    if (this == nullptr) return;
+void SyntaxAnalysis::syntax_error(const char *format, ...) {
+    if (recovering) return;
+    recovering = true;
 
-    if (traversal_type == PREORDER) function(this);
-    if (this->left != nullptr) this->left->process_tree_using(function, traversal_type);
-    if (traversal_type == INORDER) function(this);
-    if (this->right != nullptr) this->right->process_tree_using(function, traversal_type);
-    if (traversal_type == POSTORDER) function(this);
+    if (current_token.type == LEX_TOKEN_ERROR) return;
+
+    va_list args;
+    va_start(args, format);
+    diagnostics->report_list(SYNTAX_ANALYSIS_ERROR_CODE, current_token.line, current_token.column, format, args);
+    va_end(args);
 }
-#pragma clang diagnostic pop
 
-SyntaxAnalysis::SyntaxAnalysis(LexicalAnalysis *lexical_analysis)
-    : current_token(nullptr), lexical_analysis(lexical_analysis) {}
+void SyntaxAnalysis::synchronize() {
+    while (current_token.type != LEX_TOKEN_EOF) {
+        // A closing bracket ends the enclosing block, without one it is dropped on its own
+        if (current_token.type == LEX_TOKEN_RIGHT_CURLY_BRACKET) {
+            if (block_depth == 0) { GET_NEXT_TOKEN }
+            break;
+        }
+
+        bool is_end = current_token.type == LEX_TOKEN_SEMICOLON;
+        GET_NEXT_TOKEN
+        if (is_end) break;
+    }
+
+    recovering = false;
+}
 
-void SyntaxAnalysis::expect_token(LEXICAL_TOKEN_TYPE type) {
-    if (current_token->get_type() == type) {
+bool SyntaxAnalysis::expect_token(LEXICAL_TOKEN_TYPE type) {
+    if (current_token.type == type) {
         GET_NEXT_TOKEN
-        return;
+        return true;
+    }
+
+    syntax_error("Unexpected token: %s. Expected: %s", token_value(current_token).c_str(),
+                 attributes.at(type).get_text().c_str());
+    return false;
+}
+
+SyntaxTree *SyntaxAnalysis::statement_list(SYNTAX_ANALYSIS_NODE_TYPE type) {
+    // Nested blocks share the pending statements, each list takes its own statements off the end
+    size_t first = pending_statements.size();
+
+    // A closing bracket only ends a block, at the top level it is reported by statement() and skipped
+    while (current_token.type != LEX_TOKEN_EOF && !diagnostics->is_full()) {
+        if (current_token.type == LEX_TOKEN_RIGHT_CURLY_BRACKET && block_depth > 0) break;
+
+        auto list_statement = statement();
+        if (list_statement != nullptr) pending_statements.push_back(list_statement);
     }
 
-    throw SyntaxAnalysisError("Unexpected token: %s. Expected: %s", current_token->get_value().c_str(),
-                              attributes.at(type).get_text().c_str());
+    auto count = (uint32_t) (pending_statements.size() - first);
+    auto statements = arena->allocate_array<SyntaxTree *>(count);
+    std::copy(pending_statements.begin() + first, pending_statements.end(), statements);
+    pending_statements.resize(first);
+
+    return arena->create<SyntaxTree>(type, statements, count);
 }
 
 SyntaxTree *SyntaxAnalysis::expression(int precedence) {
     SyntaxTree *x = nullptr, *node;
-    SYNTAX_ANALYSIS_NODE_TYPE op;
 
-    switch (current_token->get_type()) {
+    switch (current_token.type) {
         case LEX_TOKEN_LEFT_PARENTHESIS:
             x = parenthesis_expression();
             break;
         case LEX_TOKEN_INTEGER_LITERAL:
-        case LEX_TOKEN_FLOAT_LITERAL: {
-            SYNTAX_ANALYSIS_NODE_TYPE type = attributes.at(current_token->get_type()).get_type();
-            x = new SyntaxTree(type, new std::string(current_token->get_value()));
+        case LEX_TOKEN_FLOAT_LITERAL:
+            x = literal_node();
             GET_NEXT_TOKEN
             break;
-        }
         case LEX_TOKEN_IDENTIFIER:
-            x = new SyntaxTree(SYN_NODE_IDENTIFIER, new std::string(current_token->get_value()));
+            x = identifier_node();
             GET_NEXT_TOKEN
             break;
         default:
-            throw SyntaxAnalysisError("Expected expression but found: %s", current_token->get_value().c_str());
+            syntax_error("Expected expression but found: %s", token_value(current_token).c_str());
     }
 
-    while (attributes.at(current_token->get_type()).is_binary() &&
-           attributes.at(current_token->get_type()).get_precedence() >= precedence) {
-        LEXICAL_TOKEN_TYPE internal_op = current_token->get_type();
+    if (x == nullptr) return nullptr;
+
+    while (attributes.at(current_token.type).is_binary() &&
+           attributes.at(current_token.type).get_precedence() >= precedence) {
+        LEXICAL_TOKEN_TYPE internal_op = current_token.type;
 
         GET_NEXT_TOKEN
 
         int q = attributes.at(internal_op).get_precedence();
 
         node = expression(q + 1);
-        x = new SyntaxTree(attributes.at(internal_op).get_type(), x, node);
+        if (node == nullptr) return nullptr;
+
+        x = arena->create<SyntaxTree>(attributes.at(internal_op).get_type(), x, node);
     }
 
     return x;
 }
 
 SyntaxTree *SyntaxAnalysis::parenthesis_expression() {
-    this->expect_token(LEX_TOKEN_LEFT_PARENTHESIS);
+    if (!this->expect_token(LEX_TOKEN_LEFT_PARENTHESIS)) return nullptr;
     auto *tree = expression(0);
-    this->expect_token(LEX_TOKEN_RIGHT_PARENTHESIS);
+    if (tree == nullptr || !this->expect_token(LEX_TOKEN_RIGHT_PARENTHESIS)) return nullptr;
 
     return tree;
 }
 
 SyntaxTree *SyntaxAnalysis::statement() {
-    SyntaxTree *tree = nullptr, *v, *e, *s, *e2;
+    SyntaxTree *tree = nullptr, *v, *e, *s;
+    uint32_t line = current_token.line, column = current_token.column;
 
-    switch (current_token->get_type()) {
+    switch (current_token.type) {
         case LEX_TOKEN_INTEGER_LITERAL:
         case LEX_TOKEN_FLOAT_LITERAL:
             tree = expression(0);
@@ -144,15 +285,20 @@ SyntaxTree *SyntaxAnalysis::statement() {
             break;
         case LEX_TOKEN_CONST:
         case LEX_TOKEN_VAR: {
-            bool is_constant = current_token->get_type() == LEX_TOKEN_CONST;
+            bool is_constant = current_token.type == LEX_TOKEN_CONST;
             GET_NEXT_TOKEN
 
-            v = new SyntaxTree(SYN_NODE_IDENTIFIER, new std::string(current_token->get_value()));
+            if (current_token.type != LEX_TOKEN_IDENTIFIER) {
+                expect_token(LEX_TOKEN_IDENTIFIER);
+                break;
+            }
+
+            v = identifier_node();
 
             expect_token(LEX_TOKEN_IDENTIFIER);
-            expect_token(LEX_TOKEN_ASSIGN);
+            if (!expect_token(LEX_TOKEN_ASSIGN) || (e = expression(0)) == nullptr) break;
 
-            tree = new SyntaxTree(SYN_NODE_ASSIGNMENT, v, expression(0));
+            tree = arena->create<SyntaxTree>(SYN_NODE_ASSIGNMENT, v, e);
             tree->attributes |= SYN_TREE_ATTR_DECLARATION;
             if (is_constant) tree->attributes |= SYN_TREE_ATTR_CONSTANT;
 
@@ -160,31 +306,64 @@ SyntaxTree *SyntaxAnalysis::statement() {
             break;
         }
         case LEX_TOKEN_IDENTIFIER: {
-            v = new SyntaxTree(SYN_NODE_IDENTIFIER, new std::string(current_token->get_value()));
+            v = identifier_node();
 
             expect_token(LEX_TOKEN_IDENTIFIER);
-            expect_token(LEX_TOKEN_ASSIGN);
+            if (!expect_token(LEX_TOKEN_ASSIGN) || (e = expression(0)) == nullptr) break;
 
-            tree = new SyntaxTree(SYN_NODE_ASSIGNMENT, v, expression(0));
+            tree = arena->create<SyntaxTree>(SYN_NODE_ASSIGNMENT, v, e);
 
             expect_token(LEX_TOKEN_SEMICOLON);
             break;
         }
+        case LEX_TOKEN_LEFT_CURLY_BRACKET: {
+            GET_NEXT_TOKEN
+
+            block_depth++;
+            s = statement_list(SYN_NODE_BLOCK);
+            block_depth--;
+
+            expect_token(LEX_TOKEN_RIGHT_CURLY_BRACKET);
+
+            tree = s;
+            tree->line = line;
+            tree->column = column;
+            break;
+        }
         default:
-            throw SyntaxAnalysisError("Expected statement but found: %s", current_token->get_value().c_str());
+            syntax_error("Expected statement but found: %s", token_value(current_token).c_str());
+    }
+
+    if (recovering) {
+        synchronize();
+        return nullptr;
     }
 
     return tree;
 }
 
+void SyntaxAnalysis::start_statements() {
+    tokens = lexical_analysis->tokenize();
+    token_index = 0;
+    current_token = tokens[token_index];
+    block_depth = 0;
+    recovering = false;
+
+    pending_statements.clear();
+}
+
+bool SyntaxAnalysis::is_at_end() const { return current_token.type == LEX_TOKEN_EOF; }
+
+LexicalToken SyntaxAnalysis::get_previous_token() const { return tokens[token_index > 0 ? token_index - 1 : 0]; }
+
 SyntaxTree *SyntaxAnalysis::build_tree() {
-    GET_NEXT_TOKEN
+    start_statements();
 
-    SyntaxTree *tree = nullptr;
+    SyntaxTree *tree = statement_list(SYN_NODE_SEQUENCE);
 
-    while (current_token != nullptr && current_token->get_type() != LEX_TOKEN_EOF) {
-        tree = new SyntaxTree(SYN_NODE_SEQUENCE, tree, statement());
-    }
+    // The lexical errors of the whole source were reported before the first syntax error
+    diagnostics->sort_by_position();
 
+    context->set_syntax_tree(tree);
     return tree;
 }
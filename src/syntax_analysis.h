@@ -7,15 +7,20 @@
 #ifndef SOMA_COMPILER_SYNTAX_ANALYSIS_H
 #define SOMA_COMPILER_SYNTAX_ANALYSIS_H
 
+#include <cstdint>
 #include <map>
 #include <string>
-#include <functional>
+#include <vector>
+#include "lexical_analysis.h"
+#include "string_interner.h"
+#include "util/arena.h"
 #include "util/enum.h"
+#include "util/small_stack.h"
 #include "util/types.h"
 
 #define GET_NEXT_TOKEN                                                                                                 \
-    delete current_token;                                                                                              \
-    current_token = lexical_analysis->get_token();
+    if (token_index + 1 < tokens.size()) token_index++;                                                                \
+    current_token = tokens[token_index];
 
 class SyntaxAnalysisAttribute {
 private:
@@ -54,41 +59,251 @@ typedef enum {
 
 ENUM_BIT_CASTING(SYN_TREE_ATTRIBUTE)
 
+#define SYN_NODE_STATEMENT_LIST (SYN_NODE_SEQUENCE | SYN_NODE_BLOCK)
+
+/**
+ * Node of the syntax tree. Sequence and block nodes hold their statements in program order in an arena array instead
+ * of children, every other node has at most a left and a right child. Literals hold their decoded number, identifiers
+ * their name.
+ */
 class SyntaxTree {
 public:
     SYNTAX_ANALYSIS_NODE_TYPE type;
-    std::string *value;
+    uint32_t statement_count;
+    union {
+        const char *value;
+        SyntaxTree **statements;
+        int64_t integer_value;
+        double float_value;
+    };
+    SymbolId symbol;
+    SymbolSlot slot;
     SyntaxTree *left;
     SyntaxTree *right;
     SYN_TREE_ATTRIBUTE attributes;
+    // Type of the value of an expression node, annotated by the semantic analysis
+    SYM_TABLE_DATA_TYPE data_type;
+    uint32_t line;
+    uint32_t column;
 
-    SyntaxTree(SYNTAX_ANALYSIS_NODE_TYPE type, std::string *value);
+    SyntaxTree(SYNTAX_ANALYSIS_NODE_TYPE type, const char *value);
 
     SyntaxTree(SYNTAX_ANALYSIS_NODE_TYPE type, SyntaxTree *left, SyntaxTree *right);
 
-    void process_tree_using(const std::function<void(SyntaxTree *)> &function, TRAVERSAL_TYPE traversal_type);
+    SyntaxTree(SYNTAX_ANALYSIS_NODE_TYPE type, SyntaxTree **statements, uint32_t statement_count);
+
+    /**
+     * Calls the function for every node of the tree. The traversal keeps its own stack instead of recursing, so the
+     * depth of the tree is limited by memory only, and the function is inlined instead of called through a pointer.
+     * Statement lists are visited before their statements, except in postorder. A subtree shared within a DAG is
+     * visited at each of its positions, except that postorder visits it once when it is both children of a node.
+     */
+    template<typename F>
+    void process_tree_using(F &&function, TRAVERSAL_TYPE traversal_type);
+
+    /**
+     * @return name of an identifier or the shortest text that reads back as the number of a literal, empty for
+     * other nodes
+     */
+    std::string get_text() const;
+
+private:
+    /**
+     * Traversal of a statement that is not a statement list, whose nodes have at most a left and a right child
+     */
+    template<typename F>
+    void process_expression_using(F &function, TRAVERSAL_TYPE traversal_type);
 };
 
-class LexicalAnalysis;
+// Depth of the trees built for typical expressions, deeper trees move the traversal stack to the heap
+#define SYN_TREE_TRAVERSAL_INLINE_DEPTH 64
+
+template<typename F>
+void SyntaxTree::process_tree_using(F &&function, TRAVERSAL_TYPE traversal_type) {
+    if (!(type & SYN_NODE_STATEMENT_LIST)) {
+        process_expression_using(function, traversal_type);
+        return;
+    }
+
+    // Statement lists only appear as the root and as statements, never below an expression. Each open list keeps the
+    // index of its next statement on the stack, so nested blocks are as deep as memory allows.
+    struct ListPosition {
+        SyntaxTree *list;
+        uint32_t next;
+    };
+
+    SmallStack<ListPosition, SYN_TREE_TRAVERSAL_INLINE_DEPTH> lists;
+    if (traversal_type != POSTORDER) function(this);
+    lists.push({this, 0});
+
+    while (!lists.empty()) {
+        ListPosition &position = lists.top();
+        if (position.next == position.list->statement_count) {
+            SyntaxTree *list = position.list;
+            lists.pop();
+
+            if (traversal_type == POSTORDER) function(list);
+            continue;
+        }
+
+        SyntaxTree *statement = position.list->statements[position.next++];
+        if (statement->type & SYN_NODE_STATEMENT_LIST) {
+            if (traversal_type != POSTORDER) function(statement);
+            lists.push({statement, 0});
+        } else {
+            statement->process_expression_using(function, traversal_type);
+        }
+    }
+}
+
+template<typename F>
+void SyntaxTree::process_expression_using(F &function, TRAVERSAL_TYPE traversal_type) {
+    SmallStack<SyntaxTree *, SYN_TREE_TRAVERSAL_INLINE_DEPTH> stack;
+    SyntaxTree *node = this;
+
+    switch (traversal_type) {
+        case PREORDER:
+            stack.push(node);
+            while (!stack.empty()) {
+                node = stack.top();
+                stack.pop();
+
+                function(node);
+                if (node->right != nullptr) stack.push(node->right);
+                if (node->left != nullptr) stack.push(node->left);
+            }
+            break;
+        case INORDER:
+            while (node != nullptr || !stack.empty()) {
+                for (; node != nullptr; node = node->left) stack.push(node);
 
-class LexicalToken;
+                node = stack.top();
+                stack.pop();
+
+                function(node);
+                node = node->right;
+            }
+            break;
+        case POSTORDER: {
+            // A node is visited once its right subtree was the last one finished, or when it has none
+            SyntaxTree *finished = nullptr;
+
+            while (node != nullptr || !stack.empty()) {
+                for (; node != nullptr; node = node->left) stack.push(node);
+
+                SyntaxTree *top = stack.top();
+                if (top->right != nullptr && top->right != finished) {
+                    node = top->right;
+                    continue;
+                }
+
+                stack.pop();
+                function(top);
+                finished = top;
+            }
+            break;
+        }
+    }
+}
+
+class CompilationContext;
+
+class Diagnostics;
 
 class SyntaxAnalysis {
 private:
     LexicalAnalysis *lexical_analysis;
-    LexicalToken *current_token;
+    CompilationContext *context;
+    Arena *arena;
+    StringInterner *interner;
+    Diagnostics *diagnostics;
+    std::vector<LexicalToken> tokens;
+    std::vector<SyntaxTree *> pending_statements;
+    size_t token_index;
+    LexicalToken current_token;
+    size_t block_depth;
+    bool recovering;
+
+    /**
+     * Reports an error at the current token and skips the rest of the statement. Errors following the first one of a
+     * statement and errors at tokens the lexical analysis already rejected are not reported.
+     */
+    void syntax_error(const char *format, ...);
+
+    /**
+     * Skips to the end of the statement after an error: past the next semicolon, up to the closing bracket of the
+     * enclosing block, or past a closing bracket outside of any block
+     */
+    void synchronize();
+
+    /**
+     * Consumes the token if it has the given type, reports an error otherwise
+     */
+    bool expect_token(LEXICAL_TOKEN_TYPE type);
 
-    void expect_token(LEXICAL_TOKEN_TYPE type);
+    /**
+     * Parses statements up to the closing bracket of the block or the end of the source
+     * @return statement list node with the statements in program order
+     */
+    SyntaxTree *statement_list(SYNTAX_ANALYSIS_NODE_TYPE type);
+
+    std::string token_value(LexicalToken token) const;
+
+    /**
+     * Creates a literal node with the decoded number of the current token
+     * @return nullptr after reporting an integer that does not fit into 64 bits
+     */
+    SyntaxTree *literal_node();
+
+    /**
+     * Creates an identifier node for the current token. Its value is the interned text shared by all occurrences.
+     */
+    SyntaxTree *identifier_node();
+
+    /**
+     * Creates a node positioned at the current token
+     */
+    SyntaxTree *token_node(SYNTAX_ANALYSIS_NODE_TYPE type, const char *value);
 
 public:
-    explicit SyntaxAnalysis(LexicalAnalysis *lexical_analysis);
+    /**
+     * Nodes are allocated in the arena of the context, which also receives the built tree
+     */
+    SyntaxAnalysis(LexicalAnalysis *lexical_analysis, CompilationContext *context);
 
+    /**
+     * Looks ahead without consuming. Positions past the end of the stream yield the EOF token.
+     */
+    LexicalToken peek_token(size_t distance) const;
+
+    /**
+     * @return nullptr after a syntax error
+     */
     SyntaxTree *expression(int precedence);
 
     SyntaxTree *parenthesis_expression();
 
+    /**
+     * @return nullptr after a syntax error, the statement is skipped up to its end
+     */
     SyntaxTree *statement();
 
+    /**
+     * Tokenizes the whole source and positions the analysis before its first statement, so the statements of the top
+     * level can be parsed one at a time with statement()
+     */
+    void start_statements();
+
+    bool is_at_end() const;
+
+    /**
+     * @return the last token consumed, the terminator of a statement of the top level unless it ran into the end
+     */
+    LexicalToken get_previous_token() const;
+
+    /**
+     * Builds the tree of all statements without errors. Errors are reported to the diagnostics of the context.
+     */
     SyntaxTree *build_tree();
 };
 
@@ -0,0 +1,105 @@
+/**
+ * Work-stealing thread pool
+ * @file: thread_pool.cpp
+ * @date: 17.10.2026
+ */
+
+#include "thread_pool.h"
+
+// Worker of the calling thread, so that nested submissions stay local
+static thread_local const ThreadPool *current_pool = nullptr;
+static thread_local size_t current_worker = 0;
+
+ThreadPool::ThreadPool(size_t thread_count) : queued_tasks(0), pending_tasks(0), next_queue(0), stopping(false) {
+    if (thread_count == 0) thread_count = std::thread::hardware_concurrency();
+    if (thread_count == 0) thread_count = 1;
+
+    for (size_t i = 0; i < thread_count; i++) queues.emplace_back(new WorkerQueue());
+    for (size_t i = 0; i < thread_count; i++) workers.emplace_back(&ThreadPool::run_worker, this, i);
+}
+
+ThreadPool::~ThreadPool() {
+    wait();
+
+    {
+        std::lock_guard<std::mutex> lock(state_mutex);
+        stopping = true;
+    }
+    work_available.notify_all();
+
+    for (auto &worker: workers) worker.join();
+}
+
+bool ThreadPool::pop_task(size_t index, std::function<void()> *task) {
+    for (size_t i = 0; i < queues.size(); i++) {
+        auto &queue = *queues[(index + i) % queues.size()];
+        std::lock_guard<std::mutex> lock(queue.mutex);
+
+        if (queue.tasks.empty()) continue;
+
+        // The owner works from the back while thieves take the oldest task from the front
+        if (i == 0) {
+            *task = std::move(queue.tasks.back());
+            queue.tasks.pop_back();
+        } else {
+            *task = std::move(queue.tasks.front());
+            queue.tasks.pop_front();
+        }
+
+        queued_tasks--;
+        return true;
+    }
+
+    return false;
+}
+
+void ThreadPool::run_worker(size_t index) {
+    current_pool = this;
+    current_worker = index;
+
+    std::function<void()> task;
+
+    while (true) {
+        if (pop_task(index, &task)) {
+            task();
+            task = nullptr;
+
+            if (--pending_tasks == 0) {
+                std::lock_guard<std::mutex> lock(state_mutex);
+                all_done.notify_all();
+            }
+            continue;
+        }
+
+        std::unique_lock<std::mutex> lock(state_mutex);
+        work_available.wait(lock, [this]() { return stopping || queued_tasks > 0; });
+
+        if (stopping && queued_tasks == 0) return;
+    }
+}
+
+void ThreadPool::submit(std::function<void()> task) {
+    size_t index = current_pool == this ? current_worker : next_queue++ % queues.size();
+
+    pending_tasks++;
+
+    {
+        // Counted under the state lock before the task is visible, so a worker going to sleep cannot miss it and the
+        // count never drops below zero
+        std::lock_guard<std::mutex> lock(state_mutex);
+        queued_tasks++;
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(queues[index]->mutex);
+        queues[index]->tasks.push_back(std::move(task));
+    }
+    work_available.notify_one();
+}
+
+void ThreadPool::wait() {
+    std::unique_lock<std::mutex> lock(state_mutex);
+    all_done.wait(lock, [this]() { return pending_tasks == 0; });
+}
+
+size_t ThreadPool::get_thread_count() const { return workers.size(); }
@@ -0,0 +1,73 @@
+/**
+ * Work-stealing thread pool
+ * @file: thread_pool.h
+ * @date: 17.10.2026
+ */
+
+#ifndef SOMA_COMPILER_THREAD_POOL_H
+#define SOMA_COMPILER_THREAD_POOL_H
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+/**
+ * Every worker owns a task queue. A worker takes its newest task first and, once its queue is empty, steals the
+ * oldest task of another worker, so uneven tasks spread over all threads without a single shared queue.
+ */
+class ThreadPool {
+private:
+    struct WorkerQueue {
+        std::mutex mutex;
+        std::deque<std::function<void()>> tasks;
+    };
+
+    std::vector<std::unique_ptr<WorkerQueue>> queues;
+    std::vector<std::thread> workers;
+    std::mutex state_mutex;
+    std::condition_variable work_available;
+    std::condition_variable all_done;
+    std::atomic<size_t> queued_tasks;
+    std::atomic<size_t> pending_tasks;
+    std::atomic<size_t> next_queue;
+    bool stopping;
+
+    bool pop_task(size_t index, std::function<void()> *task);
+
+    void run_worker(size_t index);
+
+public:
+    /**
+     * @param thread_count number of workers, 0 for one worker per hardware thread
+     */
+    explicit ThreadPool(size_t thread_count = 0);
+
+    ThreadPool(const ThreadPool &) = delete;
+
+    ThreadPool &operator=(const ThreadPool &) = delete;
+
+    /**
+     * Finishes all submitted tasks before joining the workers
+     */
+    ~ThreadPool();
+
+    /**
+     * Queues a task. Tasks submitted from a worker go to its own queue.
+     */
+    void submit(std::function<void()> task);
+
+    /**
+     * Blocks until every submitted task has finished
+     */
+    void wait();
+
+    size_t get_thread_count() const;
+};
+
+#endif// SOMA_COMPILER_THREAD_POOL_H
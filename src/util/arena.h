@@ -0,0 +1,114 @@
+/**
+ * Bump allocator releasing all of its allocations at once
+ * @file: arena.h
+ * @date: 17.10.2026
+ */
+
+#ifndef SOMA_COMPILER_ARENA_H
+#define SOMA_COMPILER_ARENA_H
+
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <new>
+#include <type_traits>
+#include <utility>
+
+#define ARENA_DEFAULT_BLOCK_SIZE (64 * 1024)
+
+/**
+ * Objects are never destroyed individually, so only trivially destructible types can be created in the arena.
+ * Blocks grow geometrically and are all freed when the arena is destroyed.
+ */
+class Arena {
+private:
+    struct ArenaBlock {
+        ArenaBlock *previous;
+        size_t size;
+    };
+
+    ArenaBlock *last_block;
+    char *cursor;
+    char *limit;
+    size_t next_block_size;
+    size_t allocated_bytes;
+
+    void add_block(size_t minimum_size) {
+        size_t size = next_block_size;
+        while (size < minimum_size + sizeof(ArenaBlock)) size *= 2;
+
+        auto block = (ArenaBlock *) malloc(size);
+        if (block == nullptr) throw std::bad_alloc();
+
+        block->previous = last_block;
+        block->size = size;
+        last_block = block;
+        cursor = (char *) (block + 1);
+        limit = (char *) block + size;
+        next_block_size = size * 2;
+    }
+
+public:
+    explicit Arena(size_t initial_block_size = ARENA_DEFAULT_BLOCK_SIZE)
+        : last_block(nullptr), cursor(nullptr), limit(nullptr), next_block_size(initial_block_size),
+          allocated_bytes(0) {}
+
+    Arena(const Arena &) = delete;
+
+    Arena &operator=(const Arena &) = delete;
+
+    ~Arena() {
+        while (last_block != nullptr) {
+            ArenaBlock *previous = last_block->previous;
+            free(last_block);
+            last_block = previous;
+        }
+    }
+
+    void *allocate(size_t size, size_t alignment) {
+        auto address = (uintptr_t) cursor;
+        size_t padding = (alignment - address % alignment) % alignment;
+
+        if (cursor == nullptr || size + padding > (size_t) (limit - cursor)) {
+            add_block(size + alignment);
+            address = (uintptr_t) cursor;
+            padding = (alignment - address % alignment) % alignment;
+        }
+
+        char *result = cursor + padding;
+        cursor = result + size;
+        allocated_bytes += size;
+
+        return result;
+    }
+
+    template<typename T, typename... Args>
+    T *create(Args &&...args) {
+        static_assert(std::is_trivially_destructible<T>::value, "Arena objects are never destroyed");
+
+        return new (allocate(sizeof(T), alignof(T))) T(std::forward<Args>(args)...);
+    }
+
+    template<typename T>
+    T *allocate_array(size_t count) {
+        static_assert(std::is_trivially_destructible<T>::value, "Arena objects are never destroyed");
+
+        return (T *) allocate(sizeof(T) * count, alignof(T));
+    }
+
+    /**
+     * Copies the string into the arena and terminates it with '\0'
+     */
+    const char *copy_string(const char *data, size_t length) {
+        auto copy = (char *) allocate(length + 1, 1);
+        memcpy(copy, data, length);
+        copy[length] = '\0';
+
+        return copy;
+    }
+
+    size_t get_allocated_bytes() const { return allocated_bytes; }
+};
+
+#endif// SOMA_COMPILER_ARENA_H
@@ -0,0 +1,48 @@
+/**
+ * ASCII character classes independent of the C locale
+ * @file: character_class.h
+ * @date: 17.10.2026
+ */
+
+#ifndef SOMA_COMPILER_CHARACTER_CLASS_H
+#define SOMA_COMPILER_CHARACTER_CLASS_H
+
+typedef enum {
+    CHAR_CLASS_NONE = 0x00,
+    CHAR_CLASS_WHITESPACE = 0x01,
+    CHAR_CLASS_DIGIT = 0x02,
+    CHAR_CLASS_ALPHA = 0x04,
+    CHAR_CLASS_IDENTIFIER = 0x08,
+} CHARACTER_CLASS;
+
+struct CharacterClassTable {
+    unsigned char classes[256];
+
+    constexpr CharacterClassTable() : classes() {
+        classes[(unsigned char) ' '] = CHAR_CLASS_WHITESPACE;
+        classes[(unsigned char) '\t'] = CHAR_CLASS_WHITESPACE;
+        classes[(unsigned char) '\n'] = CHAR_CLASS_WHITESPACE;
+
+        for (int c = '0'; c <= '9'; c++) classes[c] = CHAR_CLASS_DIGIT | CHAR_CLASS_IDENTIFIER;
+        for (int c = 'a'; c <= 'z'; c++) classes[c] = CHAR_CLASS_ALPHA | CHAR_CLASS_IDENTIFIER;
+        for (int c = 'A'; c <= 'Z'; c++) classes[c] = CHAR_CLASS_ALPHA | CHAR_CLASS_IDENTIFIER;
+
+        classes[(unsigned char) '_'] = CHAR_CLASS_IDENTIFIER;
+    }
+};
+
+constexpr CharacterClassTable character_classes{};
+
+inline constexpr bool has_character_class(char c, CHARACTER_CLASS character_class) {
+    return (character_classes.classes[(unsigned char) c] & character_class) != 0;
+}
+
+inline constexpr bool is_whitespace(char c) { return has_character_class(c, CHAR_CLASS_WHITESPACE); }
+
+inline constexpr bool is_digit(char c) { return has_character_class(c, CHAR_CLASS_DIGIT); }
+
+inline constexpr bool is_alpha(char c) { return has_character_class(c, CHAR_CLASS_ALPHA); }
+
+inline constexpr bool is_identifier(char c) { return has_character_class(c, CHAR_CLASS_IDENTIFIER); }
+
+#endif// SOMA_COMPILER_CHARACTER_CLASS_H
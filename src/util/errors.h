@@ -1,5 +1,5 @@
 /**
- * Errors handling
+ * Error codes reported in diagnostics
  * @file: errors.h
  * @date: 12.12.2022
  */
@@ -7,23 +7,9 @@
 #ifndef SOMA_COMPILER_ERRORS_H
 #define SOMA_COMPILER_ERRORS_H
 
-#include <exception>
-#include <cstdarg>
-#include <cstdio>
-#include <cstdlib>
+#define DRIVER_OPEN_FILE_ERROR_CODE 0x001
 
-#define ERROR_CONSTRUCTOR(code)                                                                                        \
-    va_list args;                                                                                                      \
-    va_start(args, message);                                                                                           \
-    vfprintf(stderr, message, args);                                                                                   \
-    va_end(args);                                                                                                      \
-    exit(code);
-
-#define CREATE_EXCEPTION(name, code)                                                                                   \
-    class name : public std::exception {                                                                               \
-    public:                                                                                                            \
-        explicit name(const char *message, ...) { ERROR_CONSTRUCTOR(code) }                                            \
-    };
+#define DRIVER_WRITE_FILE_ERROR_CODE 0x002
 
 #define LEXICAL_ANALYSIS_ERROR_CODE 0x101
 
@@ -37,11 +23,14 @@
 
 #define SEMANTIC_ANALYSIS_OTHER_ERROR_CODE 0x399
 
-CREATE_EXCEPTION(LexicalAnalysisError, LEXICAL_ANALYSIS_ERROR_CODE)
-CREATE_EXCEPTION(SyntaxAnalysisError, SYNTAX_ANALYSIS_ERROR_CODE)
-CREATE_EXCEPTION(SemanticAnalysisUndefinedVariableError, SEMANTIC_ANALYSIS_UNDEFINED_VARIABLE_ERROR_CODE)
-CREATE_EXCEPTION(SemanticAnalysisRedefineVariableError, SEMANTIC_ANALYSIS_REDEFINE_VARIABLE_ERROR_CODE)
-CREATE_EXCEPTION(SemanticAnalysisReassignConstantError, SEMANTIC_ANALYSIS_REASSIGN_CONSTANT_ERROR_CODE)
-CREATE_EXCEPTION(SemanticAnalysisOtherError, SEMANTIC_ANALYSIS_OTHER_ERROR_CODE)
+#define BYTECODE_REGISTER_LIMIT_ERROR_CODE 0x401
+
+#define ARTIFACT_INVALID_ERROR_CODE 0x501
+
+#define ARTIFACT_VERSION_ERROR_CODE 0x502
+
+#define ARTIFACT_CHECKSUM_ERROR_CODE 0x503
+
+#define ARTIFACT_ALIGNMENT_ERROR_CODE 0x504
 
 #endif// SOMA_COMPILER_ERRORS_H
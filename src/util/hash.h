@@ -0,0 +1,61 @@
+/**
+ * Hash functions
+ * @file: hash.h
+ * @date: 17.10.2026
+ */
+
+#ifndef SOMA_COMPILER_HASH_H
+#define SOMA_COMPILER_HASH_H
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+
+/**
+ * FNV-1a, good enough for short keys such as identifiers
+ */
+inline uint32_t fnv1a_hash(const char *data, size_t length) {
+    uint32_t hash = 2166136261u;
+
+    for (size_t i = 0; i < length; i++) {
+        hash ^= (unsigned char) data[i];
+        hash *= 16777619u;
+    }
+
+    return hash;
+}
+
+/**
+ * Finalizer of splitmix64, spreads every input bit over the whole hash
+ */
+inline uint64_t mix_hash(uint64_t value) {
+    value ^= value >> 30;
+    value *= 0xbf58476d1ce4e5b9ull;
+    value ^= value >> 27;
+    value *= 0x94d049bb133111ebull;
+    value ^= value >> 31;
+
+    return value;
+}
+
+/**
+ * Hashes eight bytes per step, for checksums and keys of whole files
+ */
+inline uint64_t hash_bytes(const void *data, size_t length, uint64_t seed = 0) {
+    const auto *bytes = (const unsigned char *) data;
+    uint64_t hash = seed ^ mix_hash(length);
+    uint64_t word;
+
+    size_t i = 0;
+    for (; i + sizeof(word) <= length; i += sizeof(word)) {
+        memcpy(&word, bytes + i, sizeof(word));
+        hash = (hash ^ mix_hash(word)) * 0x9e3779b97f4a7c15ull;
+    }
+
+    word = 0;
+    memcpy(&word, bytes + i, length - i);
+
+    return mix_hash(hash ^ word);
+}
+
+#endif// SOMA_COMPILER_HASH_H
@@ -0,0 +1,28 @@
+/**
+ * Text of numbers
+ * @file: number_format.h
+ * @date: 17.10.2026
+ */
+
+#ifndef SOMA_COMPILER_NUMBER_FORMAT_H
+#define SOMA_COMPILER_NUMBER_FORMAT_H
+
+#include <cstdio>
+#include <cstdlib>
+#include <string>
+
+/**
+ * @return the shortest text that reads back as the same double
+ */
+inline std::string format_double(double number) {
+    char text[32];
+
+    for (int precision = 1;; precision++) {
+        snprintf(text, sizeof(text), "%.*g", precision, number);
+        if (precision == 17 || std::strtod(text, nullptr) == number) break;
+    }
+
+    return text;
+}
+
+#endif// SOMA_COMPILER_NUMBER_FORMAT_H
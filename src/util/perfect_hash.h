@@ -0,0 +1,125 @@
+/**
+ * Compile time generated lookup tables for fixed sets of lexemes
+ * @file: perfect_hash.h
+ * @date: 17.10.2026
+ */
+
+#ifndef SOMA_COMPILER_PERFECT_HASH_H
+#define SOMA_COMPILER_PERFECT_HASH_H
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include "types.h"
+
+struct LexemeDefinition {
+    const char *text;
+    LEXICAL_TOKEN_TYPE type;
+};
+
+inline constexpr size_t lexeme_length(const char *text) {
+    size_t length = 0;
+    while (text[length] != '\0') length++;
+
+    return length;
+}
+
+/**
+ * FNV-1a over every character, the seed changes the initial state. Lexemes are short, so hashing all of them costs
+ * little and no two lexemes of a set are bound to collide.
+ */
+inline constexpr uint32_t lexeme_hash(const char *text, size_t length, uint32_t seed) {
+    uint32_t hash = 0x811C9DC5u ^ seed;
+    for (size_t i = 0; i < length; i++) {
+        hash ^= (unsigned char) text[i];
+        hash *= 0x01000193u;
+    }
+
+    return hash ^ (hash >> 15);
+}
+
+// Seeds tried before the search gives up, low enough to stay within the constexpr evaluation limits of compilers
+#define PERFECT_HASH_SEED_LIMIT 4096
+
+/**
+ * Deliberately not constexpr: reaching it while a table is built at compile time fails the compilation with its name
+ * in the error, instead of searching forever
+ */
+inline void perfect_hash_seed_not_found() {}
+
+/**
+ * Collision free hash table over a fixed set of lexemes. The seed is searched for at compile time, so a lookup is
+ * one hash, one length check and one memcmp against the only possible candidate.
+ */
+template<size_t SLOTS, size_t COUNT>
+class PerfectHashTable {
+    static_assert((SLOTS & (SLOTS - 1)) == 0, "Slot count must be a power of two");
+    static_assert(COUNT < SLOTS, "Slot count must exceed the lexeme count");
+
+private:
+    const LexemeDefinition *definitions;
+    uint32_t seed;
+    int slots[SLOTS];
+    size_t lengths[SLOTS];
+
+    constexpr bool try_seed(uint32_t candidate) {
+        for (size_t i = 0; i < SLOTS; i++) slots[i] = -1;
+
+        for (size_t i = 0; i < COUNT; i++) {
+            const char *text = definitions[i].text;
+            uint32_t slot = lexeme_hash(text, lexeme_length(text), candidate) & (SLOTS - 1);
+
+            if (slots[slot] != -1) return false;
+            slots[slot] = (int) i;
+            lengths[slot] = lexeme_length(text);
+        }
+
+        return true;
+    }
+
+public:
+    explicit constexpr PerfectHashTable(const LexemeDefinition (&definitions)[COUNT])
+        : definitions(definitions), seed(0), slots(), lengths() {
+        while (!try_seed(seed)) {
+            if (++seed == PERFECT_HASH_SEED_LIMIT) {
+                perfect_hash_seed_not_found();
+                break;
+            }
+        }
+    }
+
+    constexpr uint32_t get_seed() const { return seed; }
+
+    LEXICAL_TOKEN_TYPE find(const char *text, size_t length) const {
+        uint32_t slot = lexeme_hash(text, length, seed) & (SLOTS - 1);
+        if (slots[slot] < 0 || lengths[slot] != length) return LEX_TOKEN_NONE;
+
+        const LexemeDefinition &definition = definitions[slots[slot]];
+        if (memcmp(definition.text, text, length) != 0) return LEX_TOKEN_NONE;
+
+        return definition.type;
+    }
+};
+
+/**
+ * Direct lookup table for lexemes made of one character
+ */
+class CharacterLexemeTable {
+private:
+    LEXICAL_TOKEN_TYPE types[256];
+
+public:
+    template<size_t COUNT>
+    explicit constexpr CharacterLexemeTable(const LexemeDefinition (&definitions)[COUNT]) : types() {
+        for (size_t i = 0; i < 256; i++) types[i] = LEX_TOKEN_NONE;
+
+        for (size_t i = 0; i < COUNT; i++) {
+            const char *text = definitions[i].text;
+            if (lexeme_length(text) == 1) types[(unsigned char) text[0]] = definitions[i].type;
+        }
+    }
+
+    constexpr LEXICAL_TOKEN_TYPE find(char c) const { return types[(unsigned char) c]; }
+};
+
+#endif// SOMA_COMPILER_PERFECT_HASH_H
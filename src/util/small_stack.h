@@ -0,0 +1,67 @@
+/**
+ * Stack keeping its first elements inline
+ * @file: small_stack.h
+ * @date: 17.10.2026
+ */
+
+#ifndef SOMA_COMPILER_SMALL_STACK_H
+#define SOMA_COMPILER_SMALL_STACK_H
+
+#include <cstddef>
+#include <cstdlib>
+#include <cstring>
+#include <new>
+#include <type_traits>
+
+/**
+ * Stack of trivially copyable elements. The first INLINE_CAPACITY elements live inside the object, so shallow use
+ * never allocates. Deeper stacks move to a heap buffer that grows geometrically.
+ */
+template<typename T, size_t INLINE_CAPACITY>
+class SmallStack {
+    static_assert(std::is_trivially_copyable<T>::value, "SmallStack elements are moved with memcpy");
+
+private:
+    T inline_elements[INLINE_CAPACITY];
+    T *elements;
+    size_t count;
+    size_t capacity;
+
+    void grow() {
+        size_t new_capacity = capacity * 2;
+        auto new_elements = (T *) malloc(new_capacity * sizeof(T));
+        if (new_elements == nullptr) throw std::bad_alloc();
+
+        memcpy(new_elements, elements, count * sizeof(T));
+        if (elements != inline_elements) free(elements);
+
+        elements = new_elements;
+        capacity = new_capacity;
+    }
+
+public:
+    SmallStack() : elements(inline_elements), count(0), capacity(INLINE_CAPACITY) {}
+
+    SmallStack(const SmallStack &) = delete;
+
+    SmallStack &operator=(const SmallStack &) = delete;
+
+    ~SmallStack() {
+        if (elements != inline_elements) free(elements);
+    }
+
+    void push(const T &element) {
+        if (count == capacity) grow();
+        elements[count++] = element;
+    }
+
+    void pop() { count--; }
+
+    T &top() { return elements[count - 1]; }
+
+    bool empty() const { return count == 0; }
+
+    size_t size() const { return count; }
+};
+
+#endif// SOMA_COMPILER_SMALL_STACK_H
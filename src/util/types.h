@@ -7,11 +7,18 @@
 #ifndef SOMA_COMPILER_TYPES_H
 #define SOMA_COMPILER_TYPES_H
 
+#include <cstdint>
+
+// Dense index of a declaration, assigned by semantic analysis
+typedef uint32_t SymbolSlot;
+#define SYMBOL_SLOT_NONE ((SymbolSlot) -1)
+
 typedef enum {
     // System types
     LEX_TOKEN_EOF,
     LEX_TOKEN_IDENTIFIER,
     LEX_TOKEN_SEMICOLON,
+    LEX_TOKEN_ERROR,
 
     // Bracket types
     LEX_TOKEN_LEFT_PARENTHESIS,
@@ -35,13 +42,17 @@ typedef enum {
     // Keyword types
     LEX_TOKEN_CONST,
     LEX_TOKEN_VAR,
+
+    // No token, the result of a failed lexeme lookup
+    LEX_TOKEN_NONE,
 } LEXICAL_TOKEN_TYPE;
 
 typedef enum {
-    // System types
+    // System types, sequences and blocks hold a flat list of statements
     SYN_NODE_SEQUENCE = 0x01,
     SYN_NODE_IDENTIFIER = 0x02,
     SYN_NODE_ASSIGNMENT = 0x04,
+    SYN_NODE_BLOCK = 0x200,
 
     // Operator types
     SYN_NODE_ADD = 0x08,
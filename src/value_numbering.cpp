@@ -0,0 +1,148 @@
+/**
+ * Common subexpression elimination by hash-consing expressions into a DAG
+ * @file: value_numbering.cpp
+ * @date: 17.10.2026
+ */
+
+#include <cstring>
+#include <utility>
+#include "value_numbering.h"
+#include "syntax_analysis.h"
+#include "compilation_context.h"
+#include "util/hash.h"
+
+#define VALUE_NUMBERING_INITIAL_SLOTS 64
+
+ValueNumbering::ValueNumbering(CompilationContext *context)
+    : root_tree(context->get_syntax_tree()), slots(VALUE_NUMBERING_INITIAL_SLOTS, VALUE_NUMBER_NONE),
+      shared_count(0) {}
+
+uint64_t ValueNumbering::hash_key(const ValueKey &key) {
+    return mix_hash(mix_hash(mix_hash((uint64_t) key.type) ^ key.first) ^ key.second);
+}
+
+size_t ValueNumbering::find_slot(const ValueKey &key, uint64_t hash) const {
+    size_t mask = slots.size() - 1;
+    size_t slot = hash & mask;
+
+    while (slots[slot] != VALUE_NUMBER_NONE) {
+        const ValueKey &candidate = keys[slots[slot]];
+
+        if (candidate.type == key.type && candidate.first == key.first && candidate.second == key.second)
+            return slot;
+
+        slot = (slot + 1) & mask;
+    }
+
+    return slot;
+}
+
+void ValueNumbering::grow() {
+    std::vector<ValueNumber> new_slots(slots.size() * 2, VALUE_NUMBER_NONE);
+    size_t mask = new_slots.size() - 1;
+
+    for (ValueNumber value = 0; value < keys.size(); value++) {
+        size_t slot = hash_key(keys[value]) & mask;
+        while (new_slots[slot] != VALUE_NUMBER_NONE) slot = (slot + 1) & mask;
+
+        new_slots[slot] = value;
+    }
+
+    slots.swap(new_slots);
+}
+
+ValueNumber ValueNumbering::number(const ValueKey &key, SyntaxTree *node) {
+    size_t slot = find_slot(key, hash_key(key));
+
+    if (slots[slot] != VALUE_NUMBER_NONE) {
+        shared_count++;
+        return slots[slot];
+    }
+
+    auto value = (ValueNumber) keys.size();
+    keys.push_back(key);
+    nodes.push_back(node);
+    slots[slot] = value;
+
+    // Keep the load factor at most one half so probe sequences stay short
+    if (keys.size() * 2 > slots.size()) grow();
+
+    return value;
+}
+
+uint32_t &ValueNumbering::version(SymbolSlot slot) {
+    if (slot >= versions.size()) versions.resize(slot + 1, 0);
+
+    return versions[slot];
+}
+
+SyntaxTree *ValueNumbering::share_expression(SyntaxTree *expression) {
+    operands.clear();
+
+    // Operands are numbered before their operator, their numbers wait on the operand stack
+    expression->process_tree_using(
+            [&](SyntaxTree *node) {
+                ValueKey key{node->type, 0, 0};
+
+                switch (node->type) {
+                    case SYN_NODE_IDENTIFIER:
+                        key.first = node->slot;
+                        key.second = version(node->slot);
+                        break;
+                    case SYN_NODE_INTEGER_LITERAL:
+                        key.first = (uint64_t) node->integer_value;
+                        break;
+                    case SYN_NODE_FLOAT_LITERAL:
+                        // Compared by bits, so 0.0 and -0.0 stay apart
+                        memcpy(&key.first, &node->float_value, sizeof(double));
+                        break;
+                    default: {
+                        ValueNumber right = operands.back();
+                        operands.pop_back();
+                        ValueNumber left = operands.back();
+                        operands.pop_back();
+
+                        node->left = nodes[left];
+                        node->right = nodes[right];
+
+                        // Addition and multiplication commute for integers and floats alike
+                        if (node->type & (SYN_NODE_ADD | SYN_NODE_MUL) && left > right) std::swap(left, right);
+
+                        key.first = left;
+                        key.second = right;
+                    }
+                }
+
+                operands.push_back(number(key, node));
+            },
+            POSTORDER);
+
+    return nodes[operands.back()];
+}
+
+void ValueNumbering::share_statements(SyntaxTree *list) {
+    for (uint32_t i = 0; i < list->statement_count; i++) {
+        SyntaxTree *statement = list->statements[i];
+
+        if (statement->type == SYN_NODE_ASSIGNMENT) {
+            statement->right = share_expression(statement->right);
+
+            // Later uses of the variable read a new value
+            version(statement->left->slot)++;
+        } else if (statement->type == SYN_NODE_BLOCK) {
+            share_statements(statement);
+        } else {
+            list->statements[i] = share_expression(statement);
+        }
+    }
+}
+
+void ValueNumbering::share() {
+    if (root_tree == nullptr) return;
+
+    share_statements(root_tree);
+}
+
+size_t ValueNumbering::get_shared_count() const { return shared_count; }
+
+size_t ValueNumbering::get_value_count() const { return keys.size(); }
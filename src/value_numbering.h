@@ -0,0 +1,93 @@
+/**
+ * Common subexpression elimination by hash-consing expressions into a DAG
+ * @file: value_numbering.h
+ * @date: 17.10.2026
+ */
+
+#ifndef SOMA_COMPILER_VALUE_NUMBERING_H
+#define SOMA_COMPILER_VALUE_NUMBERING_H
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+#include "util/types.h"
+
+class SyntaxTree;
+
+class CompilationContext;
+
+typedef uint32_t ValueNumber;
+
+#define VALUE_NUMBER_NONE ((ValueNumber) -1)
+
+/**
+ * Numbers the values of all expressions in program order. Two nodes get the same number when they have the same
+ * node type and operands with the same numbers, a variable use is numbered by its slot and the assignment it reads.
+ * Every node is then replaced by the first node of its number, so equal computations are shared and the expressions
+ * of the program form a DAG.
+ */
+class ValueNumbering {
+private:
+    struct ValueKey {
+        SYNTAX_ANALYSIS_NODE_TYPE type;
+        uint64_t first;
+        uint64_t second;
+    };
+
+    SyntaxTree *root_tree;
+    // Key and first node of every value number
+    std::vector<ValueKey> keys;
+    std::vector<SyntaxTree *> nodes;
+    // Open addressing table of value numbers, VALUE_NUMBER_NONE marks an empty slot
+    std::vector<ValueNumber> slots;
+    // Number of assignments made to each variable slot so far
+    std::vector<uint32_t> versions;
+    std::vector<ValueNumber> operands;
+    size_t shared_count;
+
+    static uint64_t hash_key(const ValueKey &key);
+
+    size_t find_slot(const ValueKey &key, uint64_t hash) const;
+
+    void grow();
+
+    /**
+     * @return number of the key, the node becomes the first node of a new number when the key is not known yet
+     */
+    ValueNumber number(const ValueKey &key, SyntaxTree *node);
+
+    uint32_t &version(SymbolSlot slot);
+
+    /**
+     * @return the shared node of the expression value
+     */
+    SyntaxTree *share_expression(SyntaxTree *expression);
+
+    void share_statements(SyntaxTree *list);
+
+public:
+    /**
+     * Shares the expressions of the syntax tree of the context
+     */
+    explicit ValueNumbering(CompilationContext *context);
+
+    ~ValueNumbering() = default;
+
+    /**
+     * Shares the expressions of an analysed tree, whose variables have their slots. A tree is shared once, its nodes
+     * must not be rewritten in place afterwards.
+     */
+    void share();
+
+    /**
+     * @return number of expression nodes replaced by an equal node computed before
+     */
+    size_t get_shared_count() const;
+
+    /**
+     * @return number of distinct values in the program
+     */
+    size_t get_value_count() const;
+};
+
+#endif// SOMA_COMPILER_VALUE_NUMBERING_H
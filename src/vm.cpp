@@ -0,0 +1,130 @@
+/**
+ * Register virtual machine running bytecode
+ * @file: vm.cpp
+ * @date: 17.10.2026
+ */
+
+#include <algorithm>
+#include "vm.h"
+#include "optimiser.h"
+
+VirtualMachine::VirtualMachine(const BytecodeView &program)
+    : program(program), registers(program.register_count, BytecodeValue{0}) {
+    std::copy(program.constants, program.constants + program.constant_count,
+              registers.begin() + program.variable_count);
+}
+
+VirtualMachine::VirtualMachine(const BytecodeProgram *program) : VirtualMachine(program->get_view()) {}
+
+// The arithmetic is the one of constant folding, so integers wrap around in every backend
+#define VM_BINARY(type, function)                                                                                      \
+    r[ip->get_dest()].set_##type(function(r[ip->operands[0]].get_##type(), r[ip->operands[1]].get_##type()))
+
+void VirtualMachine::run() {
+#if SOMA_VM_COMPUTED_GOTO
+    static void *const labels[BC_OP_COUNT] = {
+            &&halt,      &&move,      &&int_to_float, &&add_int,  &&sub_int,
+            &&mul_int,   &&add_float, &&sub_float,    &&mul_float, &&div_float,
+    };
+
+    BytecodeValue *r = registers.data();
+    const BytecodeInstruction *ip = program.instructions;
+
+    // Every handler ends with its own indirect jump, which gives the branch predictor one site per opcode
+#define VM_DISPATCH() goto *labels[ip->get_opcode()]
+#define VM_NEXT()                                                                                                      \
+    ip++;                                                                                                              \
+    VM_DISPATCH()
+
+    if (program.instruction_count == 0) return;
+    VM_DISPATCH();
+
+move:
+    r[ip->get_dest()] = r[ip->operands[0]];
+    VM_NEXT();
+int_to_float:
+    r[ip->get_dest()].set_float((double) r[ip->operands[0]].get_integer());
+    VM_NEXT();
+add_int:
+    VM_BINARY(integer, optimiser_add);
+    VM_NEXT();
+sub_int:
+    VM_BINARY(integer, optimiser_sub);
+    VM_NEXT();
+mul_int:
+    VM_BINARY(integer, optimiser_mul);
+    VM_NEXT();
+add_float:
+    VM_BINARY(float, optimiser_add);
+    VM_NEXT();
+sub_float:
+    VM_BINARY(float, optimiser_sub);
+    VM_NEXT();
+mul_float:
+    VM_BINARY(float, optimiser_mul);
+    VM_NEXT();
+div_float:
+    VM_BINARY(float, optimiser_div);
+    VM_NEXT();
+halt:
+    return;
+
+#undef VM_NEXT
+#undef VM_DISPATCH
+#else
+    run_switch();
+#endif
+}
+
+void VirtualMachine::run_switch() {
+    BytecodeValue *r = registers.data();
+    const BytecodeInstruction *ip = program.instructions;
+
+    if (program.instruction_count == 0) return;
+
+    for (;; ip++) {
+        switch (ip->get_opcode()) {
+            case BC_OP_MOVE:
+                r[ip->get_dest()] = r[ip->operands[0]];
+                break;
+            case BC_OP_INT_TO_FLOAT:
+                r[ip->get_dest()].set_float((double) r[ip->operands[0]].get_integer());
+                break;
+            case BC_OP_ADD_INT:
+                VM_BINARY(integer, optimiser_add);
+                break;
+            case BC_OP_SUB_INT:
+                VM_BINARY(integer, optimiser_sub);
+                break;
+            case BC_OP_MUL_INT:
+                VM_BINARY(integer, optimiser_mul);
+                break;
+            case BC_OP_ADD_FLOAT:
+                VM_BINARY(float, optimiser_add);
+                break;
+            case BC_OP_SUB_FLOAT:
+                VM_BINARY(float, optimiser_sub);
+                break;
+            case BC_OP_MUL_FLOAT:
+                VM_BINARY(float, optimiser_mul);
+                break;
+            case BC_OP_DIV_FLOAT:
+                VM_BINARY(float, optimiser_div);
+                break;
+            default:
+                return;
+        }
+    }
+}
+
+#undef VM_BINARY
+
+RuntimeValue VirtualMachine::get_variable(SymbolSlot slot) const {
+    RuntimeValue value{program.variable_types[slot], {0}};
+
+    if (value.type == SYM_TABLE_TYPE_INT) value.integer_value = registers[slot].get_integer();
+    else if (value.type == SYM_TABLE_TYPE_FLOAT)
+        value.float_value = registers[slot].get_float();
+
+    return value;
+}
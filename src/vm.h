@@ -0,0 +1,58 @@
+/**
+ * Register virtual machine running bytecode
+ * @file: vm.h
+ * @date: 17.10.2026
+ */
+
+#ifndef SOMA_COMPILER_VM_H
+#define SOMA_COMPILER_VM_H
+
+#include <vector>
+#include "bytecode.h"
+#include "evaluator.h"
+#include "util/types.h"
+
+// Computed goto is a GNU extension, other compilers dispatch with the switch
+#if defined(__GNUC__) && !defined(SOMA_VM_NO_COMPUTED_GOTO)
+#define SOMA_VM_COMPUTED_GOTO 1
+#else
+#define SOMA_VM_COMPUTED_GOTO 0
+#endif
+
+/**
+ * Runs a bytecode program and computes the same values as the evaluator on the tree. The registers are allocated and
+ * the constants loaded once, so running again only executes the instructions. Programs have no inputs, every run
+ * computes the same values.
+ */
+class VirtualMachine {
+private:
+    BytecodeView program;
+    std::vector<BytecodeValue> registers;
+
+public:
+    /**
+     * The program is not copied, it must outlive the machine
+     */
+    explicit VirtualMachine(const BytecodeView &program);
+
+    explicit VirtualMachine(const BytecodeProgram *program);
+
+    ~VirtualMachine() = default;
+
+    /**
+     * Dispatches with computed goto where the compiler supports it, with the switch otherwise
+     */
+    void run();
+
+    /**
+     * Portable dispatch loop, kept callable so both loops can be compared
+     */
+    void run_switch();
+
+    /**
+     * @return value of the variable after the last run, typed by its last assignment
+     */
+    RuntimeValue get_variable(SymbolSlot slot) const;
+};
+
+#endif// SOMA_COMPILER_VM_H
@@ -0,0 +1,155 @@
+/**
+ * Tests for the compiled artifact format
+ * @file: artifact_tests.cpp
+ * @date: 17.10.2026
+ */
+
+#include <gtest/gtest.h>
+#include <cstdio>
+#include <fstream>
+#include <memory>
+#include <string>
+
+#include "../src/compilation_pipeline.h"
+#include "../src/vm.h"
+#include "../src/artifact.cpp"
+
+namespace soma {
+    namespace tests {
+        namespace {
+            class ArtifactTests : public ::testing::Test {
+            protected:
+                Diagnostics diagnostics;
+
+            public:
+                /**
+                 * @return artifact of the optimised input
+                 */
+                std::string Compile(const std::string &input) {
+                    CompilationPipeline pipeline;
+                    EXPECT_TRUE(pipeline.analyze(input)) << "Input: " << input;
+
+                    return pipeline.build_artifact();
+                }
+
+                /**
+                 * @return the artifact over the data, which must outlive it
+                 */
+                Artifact *Load(const std::string &data) {
+                    return Artifact::from_buffer(new SourceBuffer(data.data(), data.size()), &diagnostics);
+                }
+
+                ArtifactHeader &Header(std::string &data) { return *(ArtifactHeader *) &data[0]; }
+
+                void UpdateChecksum(std::string &data) {
+                    Header(data).checksum =
+                            hash_bytes(data.data() + sizeof(ArtifactHeader), data.size() - sizeof(ArtifactHeader));
+                }
+
+                void ExpectRejected(const std::string &data, int code) {
+                    std::unique_ptr<Artifact> artifact(Load(data));
+                    EXPECT_EQ(artifact, nullptr);
+                    ASSERT_EQ(diagnostics.get_diagnostics().size(), 1);
+                    EXPECT_EQ(diagnostics.get_diagnostics()[0].code, code);
+                }
+            };
+
+            TEST_F(ArtifactTests, Symbols) {
+                std::string data = Compile("var a = 2; const k = 1.5; var b = a * k; { var c = b; } a = b / 2;");
+                std::unique_ptr<Artifact> artifact(Load(data));
+                ASSERT_NE(artifact, nullptr);
+
+                // Only the declarations of the top level are kept, with the types of their slots at the end
+                ASSERT_EQ(artifact->get_symbol_count(), 3);
+                EXPECT_EQ(artifact->get_name(artifact->get_symbol(0)), "a");
+                EXPECT_EQ(artifact->get_name(artifact->get_symbol(1)), "k");
+                EXPECT_EQ(artifact->get_name(artifact->get_symbol(2)), "b");
+
+                const ArtifactSymbol *constant = artifact->find_symbol("k", 1);
+                ASSERT_NE(constant, nullptr);
+                EXPECT_EQ(constant->slot, 1);
+                EXPECT_EQ(constant->data_type, SYM_TABLE_TYPE_FLOAT);
+                EXPECT_EQ(constant->flags, SYM_TABLE_IS_DEFINED | SYM_TABLE_IS_CONSTANT);
+
+                const ArtifactSymbol *variable = artifact->find_symbol("a", 1);
+                ASSERT_NE(variable, nullptr);
+                EXPECT_EQ(variable->data_type, SYM_TABLE_TYPE_FLOAT);
+                EXPECT_EQ(variable->flags, SYM_TABLE_IS_DEFINED);
+
+                EXPECT_EQ(artifact->find_symbol("c", 1), nullptr);
+            }
+
+            TEST_F(ArtifactTests, RunsFromMappedFile) {
+                std::string path = ::testing::TempDir() + "soma_artifact" ARTIFACT_EXTENSION;
+                std::ofstream(path, std::ios::binary) << Compile("var a = 3; var b = a * a; a = b + a; b = a - 0.5;");
+
+                std::unique_ptr<Artifact> artifact(Artifact::load(path.c_str(), &diagnostics));
+                ASSERT_NE(artifact, nullptr);
+
+                VirtualMachine machine(artifact->get_program());
+                machine.run();
+
+                EXPECT_EQ(machine.get_variable(artifact->find_symbol("a", 1)->slot).get_text(), "12");
+                EXPECT_EQ(machine.get_variable(artifact->find_symbol("b", 1)->slot).get_text(), "11.5");
+                EXPECT_TRUE(diagnostics.get_diagnostics().empty());
+
+                std::remove(path.c_str());
+            }
+
+            TEST_F(ArtifactTests, EmptyProgram) {
+                std::string data = Compile("");
+                std::unique_ptr<Artifact> artifact(Load(data));
+                ASSERT_NE(artifact, nullptr);
+
+                EXPECT_EQ(artifact->get_symbol_count(), 0);
+                EXPECT_EQ(artifact->get_program().instruction_count, 1);
+            }
+
+            TEST_F(ArtifactTests, RejectsOtherFiles) {
+                ExpectRejected("var a = 1;", ARTIFACT_INVALID_ERROR_CODE);
+            }
+
+            TEST_F(ArtifactTests, RejectsMisalignedBuffers) {
+                std::string data = Compile("var a = 1;");
+                std::string shifted = " " + data;
+
+                std::unique_ptr<Artifact> artifact(
+                        Artifact::from_buffer(new SourceBuffer(shifted.data() + 1, data.size()), &diagnostics));
+                EXPECT_EQ(artifact, nullptr);
+                ASSERT_EQ(diagnostics.get_diagnostics().size(), 1);
+                EXPECT_EQ(diagnostics.get_diagnostics()[0].code, ARTIFACT_ALIGNMENT_ERROR_CODE);
+            }
+
+            TEST_F(ArtifactTests, RejectsOtherVersions) {
+                std::string data = Compile("var a = 1;");
+                Header(data).version = ARTIFACT_VERSION + 1;
+
+                ExpectRejected(data, ARTIFACT_VERSION_ERROR_CODE);
+            }
+
+            TEST_F(ArtifactTests, RejectsChangedBytes) {
+                std::string data = Compile("var a = 1; var b = a + 2;");
+                data[data.size() - 1] ^= 1;
+
+                ExpectRejected(data, ARTIFACT_CHECKSUM_ERROR_CODE);
+            }
+
+            TEST_F(ArtifactTests, RejectsTruncated) {
+                std::string data = Compile("var a = 1; var b = a + 2;");
+                data.resize(data.size() - 8);
+
+                ExpectRejected(data, ARTIFACT_CHECKSUM_ERROR_CODE);
+            }
+
+            TEST_F(ArtifactTests, RejectsRegistersOutOfRange) {
+                // A consistent checksum does not make the machine read outside its registers
+                std::string data = Compile("var a = 1; var b = a + 2;");
+                auto instructions = (BytecodeInstruction *) &data[Header(data).instructions_offset];
+                instructions[0].operands[0] = Header(data).register_count;
+                UpdateChecksum(data);
+
+                ExpectRejected(data, ARTIFACT_INVALID_ERROR_CODE);
+            }
+        }// namespace
+    }    // namespace tests
+}// namespace soma
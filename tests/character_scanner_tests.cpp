@@ -0,0 +1,99 @@
+/**
+ * Tests for vectorised character run scanning
+ * @file: character_scanner_tests.cpp
+ * @date: 17.10.2026
+ */
+
+#include <gtest/gtest.h>
+#include <random>
+#include <string>
+
+#include "../src/character_scanner.cpp"
+
+namespace soma {
+    namespace tests {
+        namespace {
+            class CharacterScannerTests : public ::testing::Test {
+            protected:
+                std::vector<const CharacterScanner *> scanners;
+
+            public:
+                void SetUp() override {
+                    for (auto kind: {CHAR_SCANNER_SCALAR, CHAR_SCANNER_SSE2, CHAR_SCANNER_AVX2}) {
+                        auto scanner = CharacterScanner::get(kind);
+                        if (scanner != nullptr) scanners.push_back(scanner);
+                    }
+                }
+
+                void CompareWithScalar(const std::string &input) {
+                    auto scalar = CharacterScanner::get(CHAR_SCANNER_SCALAR);
+
+                    for (auto scanner: scanners) {
+                        for (size_t position = 0; position < input.size(); position++) {
+                            uint32_t expected_line = 1, actual_line = 1;
+                            size_t expected_line_start = 0, actual_line_start = 0;
+
+                            EXPECT_EQ(scanner->skip_whitespace(input.data(), position, input.size(), &actual_line,
+                                                               &actual_line_start),
+                                      scalar->skip_whitespace(input.data(), position, input.size(), &expected_line,
+                                                              &expected_line_start))
+                                    << "Scanner: " << scanner->kind << " Position: " << position;
+                            EXPECT_EQ(actual_line, expected_line);
+                            EXPECT_EQ(actual_line_start, expected_line_start);
+
+                            EXPECT_EQ(scanner->skip_identifier(input.data(), position, input.size()),
+                                      scalar->skip_identifier(input.data(), position, input.size()))
+                                    << "Scanner: " << scanner->kind << " Position: " << position;
+
+                            EXPECT_EQ(scanner->skip_digits(input.data(), position, input.size()),
+                                      scalar->skip_digits(input.data(), position, input.size()))
+                                    << "Scanner: " << scanner->kind << " Position: " << position;
+                        }
+                    }
+                }
+            };
+
+            TEST_F(CharacterScannerTests, CharacterClasses) {
+                EXPECT_TRUE(is_whitespace(' '));
+                EXPECT_TRUE(is_whitespace('\n'));
+                EXPECT_FALSE(is_whitespace('\r'));
+                EXPECT_TRUE(is_digit('7'));
+                EXPECT_FALSE(is_digit('a'));
+                EXPECT_TRUE(is_alpha('Z'));
+                EXPECT_FALSE(is_alpha('_'));
+                EXPECT_TRUE(is_identifier('_'));
+                EXPECT_FALSE(is_identifier((char) 0xC3));
+            }
+
+            TEST_F(CharacterScannerTests, LongRuns) {
+                CompareWithScalar(std::string(100, ' ') + "x");
+
+                CompareWithScalar("  \n\t  \n      \n\n   \t\t\t  \n          \n    \n  const");
+
+                CompareWithScalar("variable_with_a_rather_long_name_0123456789_and_even_longer = 1;");
+
+                CompareWithScalar("123456789012345678901234567890123456789012345678901234567890.5");
+
+                CompareWithScalar("abc\xC3\xA9"
+                                  "defghijklmnopqrstuvwxyzABCDEFGHIJKLMNOPQRSTUVWXYZ[`{@/:");
+            }
+
+            TEST_F(CharacterScannerTests, RandomInput) {
+                const std::string alphabet = " \t\n\rabcxyzABCXYZ_0189;=+-*/()[]{}@`:\x80\xff";
+                std::mt19937 generator(42);
+                std::uniform_int_distribution<size_t> distribution(0, alphabet.size() - 1);
+
+                for (int i = 0; i < 20; i++) {
+                    std::string input;
+                    for (int j = 0; j < 150; j++) {
+                        // Long runs of one character class are what the vectorised paths care about
+                        char c = alphabet[distribution(generator)];
+                        input.append(distribution(generator) % 40, c);
+                    }
+
+                    CompareWithScalar(input);
+                }
+            }
+        }// namespace
+    }    // namespace tests
+}// namespace soma
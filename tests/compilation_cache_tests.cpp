@@ -0,0 +1,262 @@
+/**
+ * Tests for the on-disk compilation cache
+ * @file: compilation_cache_tests.cpp
+ * @date: 17.10.2026
+ */
+
+#include <gtest/gtest.h>
+#include <ctime>
+#include <fstream>
+#include <functional>
+#include <iterator>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "../src/compilation_cache.cpp"
+#include "../src/util/errors.h"
+
+namespace soma {
+    namespace tests {
+        namespace {
+            class CompilationCacheTests : public ::testing::Test {
+            protected:
+                std::string directory = ::testing::TempDir() + "soma_cache_tests";
+
+            public:
+                void SetUp() override { TearDown(); }
+
+                void TearDown() override {
+                    for (auto &name: ListDirectory()) std::remove((directory + "/" + name).c_str());
+                    rmdir(directory.c_str());
+                }
+
+                std::vector<std::string> ListDirectory() {
+                    std::vector<std::string> names;
+
+                    DIR *cache_directory = opendir(directory.c_str());
+                    if (cache_directory == nullptr) return names;
+
+                    while (dirent *file = readdir(cache_directory)) {
+                        std::string name = file->d_name;
+                        if (name != "." && name != "..") names.push_back(name);
+                    }
+
+                    closedir(cache_directory);
+
+                    return names;
+                }
+
+                std::string EntryPath(const CacheKey &key) {
+                    char name[40];
+                    snprintf(name, sizeof(name), "%016" PRIx64 "%016" PRIx64, key.first, key.second);
+
+                    return directory + "/" + name + CACHE_ENTRY_EXTENSION;
+                }
+
+                static CompilationResult Result(const std::string &path) {
+                    return {path, true, 2, 1, 3, {}, {}, 0};
+                }
+            };
+
+            TEST_F(CompilationCacheTests, StoresAndFindsResults) {
+                CompilationCache cache(directory);
+                CacheKey key = CompilationCache::get_key("var a = 1;", 10, 0);
+
+                CompilationResult result = Result("first.soma");
+                std::string artifact_data;
+                EXPECT_FALSE(cache.lookup(key, result, artifact_data));
+
+                CompilationResult stored = Result("first.soma");
+                stored.success = false;
+                stored.diagnostics.push_back({SEMANTIC_ANALYSIS_UNDEFINED_VARIABLE_ERROR_CODE, 1, 9, "Undefined b"});
+                stored.diagnostics.push_back({SYNTAX_ANALYSIS_ERROR_CODE, 2, 1, ""});
+                stored.dropped_diagnostics = 4;
+                cache.store(key, stored, std::string("\0artifact", 9));
+
+                // The path belongs to the caller, the same source may live under any name
+                CompilationResult found{"second.soma", true, 0, 0, 0, {}, {}, 0};
+                ASSERT_TRUE(cache.lookup(key, found, artifact_data));
+
+                EXPECT_EQ(found.path, "second.soma");
+                EXPECT_FALSE(found.success);
+                EXPECT_EQ(found.variable_count, 2);
+                EXPECT_EQ(found.removed_statements, 1);
+                EXPECT_EQ(found.instruction_count, 3);
+                EXPECT_EQ(found.dropped_diagnostics, 4);
+                ASSERT_EQ(found.diagnostics.size(), 2);
+                EXPECT_EQ(found.diagnostics[0].code, SEMANTIC_ANALYSIS_UNDEFINED_VARIABLE_ERROR_CODE);
+                EXPECT_EQ(found.diagnostics[0].line, 1);
+                EXPECT_EQ(found.diagnostics[0].column, 9);
+                EXPECT_EQ(found.diagnostics[0].message, "Undefined b");
+                EXPECT_EQ(found.diagnostics[1].message, "");
+                EXPECT_EQ(artifact_data, std::string("\0artifact", 9));
+            }
+
+            TEST_F(CompilationCacheTests, KeysDependOnSourceAndOptions) {
+                CacheKey key = CompilationCache::get_key("var a = 1;", 10, 0);
+                CacheKey other_source = CompilationCache::get_key("var a = 2;", 10, 0);
+                CacheKey other_options = CompilationCache::get_key("var a = 1;", 10, 1);
+
+                EXPECT_NE(key.first, other_source.first);
+                EXPECT_NE(key.second, other_source.second);
+                EXPECT_NE(key.first, other_options.first);
+                EXPECT_NE(key.first, key.second);
+
+                CompilationCache cache(directory);
+                cache.store(key, Result("a.soma"), "");
+
+                CompilationResult result = Result("a.soma");
+                std::string artifact_data;
+                EXPECT_FALSE(cache.lookup(other_source, result, artifact_data));
+                EXPECT_FALSE(cache.lookup(other_options, result, artifact_data));
+            }
+
+            TEST_F(CompilationCacheTests, IgnoresDamagedEntries) {
+                CompilationCache cache(directory);
+                CacheKey key = CompilationCache::get_key("var a = 1;", 10, 0);
+                cache.store(key, Result("a.soma"), "artifact");
+
+                auto names = ListDirectory();
+                ASSERT_EQ(names.size(), 1);
+                std::string path = directory + "/" + names[0];
+                {
+                    std::fstream file_stream(path, std::ios::binary | std::ios::in | std::ios::out);
+                    file_stream.seekp(-1, std::ios::end);
+                    file_stream.put('x');
+                }
+
+                CompilationResult result = Result("a.soma");
+                std::string artifact_data;
+                EXPECT_FALSE(cache.lookup(key, result, artifact_data));
+
+                // A later store replaces the damaged entry
+                cache.store(key, Result("a.soma"), "artifact");
+                EXPECT_TRUE(cache.lookup(key, result, artifact_data));
+            }
+
+            TEST_F(CompilationCacheTests, IgnoresInconsistentEntries) {
+                CompilationCache cache(directory);
+                CacheKey key = CompilationCache::get_key("var a = b;", 10, 0);
+                CompilationResult stored = Result("a.soma");
+                stored.diagnostics.push_back({SEMANTIC_ANALYSIS_UNDEFINED_VARIABLE_ERROR_CODE, 1, 9, "Undefined b"});
+
+                // Entries with a valid checksum whose offsets point outside of their records
+                typedef std::function<void(CacheEntryHeader &, CacheDiagnosticRecord &)> EntryEdit;
+                auto check_rejected = [&](const EntryEdit &edit) {
+                    cache.store(key, stored, "artifact");
+
+                    std::string data;
+                    {
+                        std::ifstream file_stream(EntryPath(key), std::ios::binary);
+                        data.assign(std::istreambuf_iterator<char>(file_stream), std::istreambuf_iterator<char>());
+                    }
+
+                    CacheEntryHeader header{};
+                    CacheDiagnosticRecord record{};
+                    memcpy(&header, data.data(), sizeof(header));
+                    memcpy(&record, data.data() + sizeof(header), sizeof(record));
+                    edit(header, record);
+
+                    memcpy(&data[sizeof(header)], &record, sizeof(record));
+                    header.checksum = hash_bytes(data.data() + sizeof(header), data.size() - sizeof(header));
+                    memcpy(&data[0], &header, sizeof(header));
+                    std::ofstream(EntryPath(key), std::ios::binary) << data;
+
+                    CompilationResult result = Result("a.soma");
+                    std::string artifact_data;
+                    EXPECT_FALSE(cache.lookup(key, result, artifact_data));
+                };
+
+                check_rejected([](CacheEntryHeader &header, CacheDiagnosticRecord &) { header.artifact_offset = 8; });
+                check_rejected([](CacheEntryHeader &, CacheDiagnosticRecord &record) {
+                    record.message_length = UINT32_MAX;
+                });
+                check_rejected([](CacheEntryHeader &header, CacheDiagnosticRecord &) {
+                    header.diagnostic_count = 1000;
+                });
+            }
+
+            TEST_F(CompilationCacheTests, ConcurrentWriters) {
+                CompilationCache cache(directory);
+                CacheKey key = CompilationCache::get_key("var a = 1;", 10, 0);
+                std::string artifact(100000, 'a');
+
+                std::vector<std::thread> writers;
+                for (int i = 0; i < 8; i++) {
+                    writers.emplace_back([&]() {
+                        for (int j = 0; j < 20; j++) {
+                            cache.store(key, Result("a.soma"), artifact);
+
+                            // Readers never see a partially written entry
+                            CompilationResult result = Result("a.soma");
+                            std::string artifact_data;
+                            EXPECT_TRUE(cache.lookup(key, result, artifact_data));
+                            EXPECT_EQ(artifact_data, artifact);
+                        }
+                    });
+                }
+
+                for (auto &writer: writers) writer.join();
+
+                EXPECT_EQ(ListDirectory().size(), 1);
+            }
+
+            TEST_F(CompilationCacheTests, EvictsLeastRecentlyUsed) {
+                CompilationCache unlimited(directory);
+                std::vector<CacheKey> keys;
+                for (int i = 0; i < 3; i++) {
+                    std::string source = "var a = " + std::to_string(i) + ";";
+                    keys.push_back(CompilationCache::get_key(source.data(), source.size(), 0));
+                    unlimited.store(keys[i], Result("a.soma"), std::string(1000, 'a'));
+                }
+
+                for (int i = 0; i < 3; i++) {
+                    utimbuf times{1000 * (i + 1), 1000 * (i + 1)};
+                    utime(EntryPath(keys[i]).c_str(), &times);
+                }
+
+                // The oldest entry is used again, which makes the second one the least recently used
+                CompilationResult result = Result("a.soma");
+                std::string artifact_data;
+                ASSERT_TRUE(unlimited.lookup(keys[0], result, artifact_data));
+
+                struct stat entry_stat {};
+                ASSERT_EQ(stat(EntryPath(keys[0]).c_str(), &entry_stat), 0);
+                EXPECT_EQ(unlimited.evict(), 0);
+
+                CompilationCache limited(directory, 2 * (uint64_t) entry_stat.st_size);
+                EXPECT_EQ(limited.evict(), 1);
+
+                EXPECT_TRUE(limited.lookup(keys[0], result, artifact_data));
+                EXPECT_FALSE(limited.lookup(keys[1], result, artifact_data));
+                EXPECT_TRUE(limited.lookup(keys[2], result, artifact_data));
+            }
+
+            TEST_F(CompilationCacheTests, RemovesAbandonedTemporaryFiles) {
+                CompilationCache cache(directory);
+                std::string source = "var a = 1;";
+                CacheKey key = CompilationCache::get_key(source.data(), source.size(), 0);
+                cache.store(key, Result("a.soma"), std::string(1000, 'a'));
+
+                // A writer that died before renaming leaves its temporary file, one still writing has a recent one
+                std::string abandoned = EntryPath(key) + CACHE_TEMPORARY_EXTENSION "1.0";
+                std::string writing = EntryPath(key) + CACHE_TEMPORARY_EXTENSION "2.0";
+                std::ofstream(abandoned) << std::string(1000, 'a');
+                std::ofstream(writing) << std::string(1000, 'a');
+
+                time_t old = time(nullptr) - COMPILATION_CACHE_TEMPORARY_GRACE - 1;
+                utimbuf times{old, old};
+                utime(abandoned.c_str(), &times);
+
+                EXPECT_EQ(cache.evict(), 1);
+                EXPECT_EQ(ListDirectory().size(), 2);
+                EXPECT_NE(access(writing.c_str(), F_OK), -1);
+
+                CompilationResult result = Result("a.soma");
+                std::string artifact_data;
+                EXPECT_TRUE(cache.lookup(key, result, artifact_data));
+            }
+        }// namespace
+    }    // namespace tests
+}// namespace soma
@@ -0,0 +1,169 @@
+/**
+ * Tests for the parallel compilation driver
+ * @file: driver_tests.cpp
+ * @date: 17.10.2026
+ */
+
+#include <gtest/gtest.h>
+#include <cstdio>
+#include <fstream>
+#include <string>
+#include <vector>
+
+#include "../src/compilation_pipeline.cpp"
+#include "../src/driver.cpp"
+
+namespace soma {
+    namespace tests {
+        namespace {
+            class DriverTests : public ::testing::Test {
+            protected:
+                std::vector<std::string> paths;
+
+            public:
+                void TearDown() override {
+                    for (auto &path: paths) std::remove(path.c_str());
+                }
+
+                std::string WriteSource(const std::string &name, const std::string &source) {
+                    std::string path = ::testing::TempDir() + "soma_driver_" + name + ".soma";
+                    std::ofstream(path) << source;
+                    paths.push_back(path);
+
+                    return path;
+                }
+            };
+
+            TEST_F(DriverTests, ResultsInInputOrder) {
+                std::vector<std::string> inputs;
+                for (int i = 0; i < 64; i++) {
+                    std::string source;
+                    for (int j = 0; j <= i; j++) source += "var v" + std::to_string(j) + " = 1;";
+
+                    inputs.push_back(WriteSource(std::to_string(i), source));
+                }
+
+                Driver driver(4);
+                auto results = driver.compile_files(inputs);
+
+                ASSERT_EQ(results.size(), inputs.size());
+                for (size_t i = 0; i < results.size(); i++) {
+                    EXPECT_EQ(results[i].path, inputs[i]);
+                    EXPECT_TRUE(results[i].success);
+                    EXPECT_EQ(results[i].variable_count, i + 1);
+                }
+            }
+
+            TEST_F(DriverTests, FinalValues) {
+                DriverOptions options;
+                options.run_programs = true;
+                std::string path =
+                        WriteSource("values", "var a = 1; const k = 2; var b = a * k; a = b / 4; { var c = a; }");
+
+                auto results = Driver(1, options).compile_files({path});
+
+                ASSERT_EQ(results.size(), 1);
+                EXPECT_TRUE(results[0].success);
+                EXPECT_EQ(results[0].values, (std::vector<std::pair<std::string, std::string>>{{"a", "0.5"},
+                                                                                               {"b", "2"}}));
+
+                // Programs only run when their values are requested
+                results = Driver(1).compile_files({path});
+                ASSERT_EQ(results.size(), 1);
+                EXPECT_TRUE(results[0].success);
+                EXPECT_TRUE(results[0].values.empty());
+            }
+
+            TEST_F(DriverTests, ArtifactsRunWithoutSource) {
+                DriverOptions options;
+                options.write_artifacts = true;
+                options.run_programs = true;
+                std::string path = WriteSource("artifact", "var a = 4; var b = a * a; a = b / 8;");
+                paths.push_back(path + ARTIFACT_EXTENSION);
+
+                Driver driver(2, options);
+                auto compiled = driver.compile_files({path});
+                std::remove(path.c_str());
+                auto loaded = driver.compile_files({path + ARTIFACT_EXTENSION});
+
+                ASSERT_EQ(loaded.size(), 1);
+                EXPECT_TRUE(loaded[0].success);
+                EXPECT_EQ(loaded[0].values, compiled[0].values);
+                EXPECT_EQ(loaded[0].values, (std::vector<std::pair<std::string, std::string>>{{"a", "2"},
+                                                                                              {"b", "16"}}));
+            }
+
+            TEST_F(DriverTests, CachedResults) {
+                DriverOptions options;
+                options.run_programs = true;
+                options.cache_directory = ::testing::TempDir() + "soma_driver_cache";
+                std::vector<std::string> inputs = {WriteSource("cached", "var a = 4; var b = a * a; a = b / 8;"),
+                                                   WriteSource("cached_error", "var a = 1;\nvar a = b;")};
+
+                Driver driver(2, options);
+                auto compiled = driver.compile_files(inputs);
+
+                // Same contents under another name hit the entries written by the first run
+                std::vector<std::string> copies = {WriteSource("copy", "var a = 4; var b = a * a; a = b / 8;"),
+                                                   WriteSource("copy_error", "var a = 1;\nvar a = b;")};
+                auto cached = driver.compile_files(copies);
+
+                ASSERT_EQ(cached.size(), 2);
+                for (size_t i = 0; i < cached.size(); i++) {
+                    EXPECT_EQ(cached[i].path, copies[i]);
+                    EXPECT_EQ(cached[i].success, compiled[i].success);
+                    EXPECT_EQ(cached[i].variable_count, compiled[i].variable_count);
+                    EXPECT_EQ(cached[i].removed_statements, compiled[i].removed_statements);
+                    EXPECT_EQ(cached[i].instruction_count, compiled[i].instruction_count);
+                    EXPECT_EQ(cached[i].values, compiled[i].values);
+                    ASSERT_EQ(cached[i].diagnostics.size(), compiled[i].diagnostics.size());
+                    for (size_t j = 0; j < cached[i].diagnostics.size(); j++)
+                        EXPECT_EQ(cached[i].diagnostics[j].message, compiled[i].diagnostics[j].message);
+                }
+
+                // An option that changes the result keys other entries
+                ASSERT_EQ(compiled[1].diagnostics.size(), 2);
+                CompilationCache cache(options.cache_directory);
+                options.diagnostic_limit = 1;
+                EXPECT_EQ(Driver::compile_file(copies[1], options, &cache).diagnostics.size(), 1);
+
+                EXPECT_EQ(CompilationCache(options.cache_directory, 0).evict(), 3);
+                std::remove(options.cache_directory.c_str());
+            }
+
+            TEST_F(DriverTests, MissingFile) {
+                std::string path = ::testing::TempDir() + "soma_driver_missing.soma";
+
+                Driver driver(2);
+                auto results = driver.compile_files({WriteSource("present", "var a = 1;"), path});
+
+                ASSERT_EQ(results.size(), 2);
+                EXPECT_TRUE(results[0].success);
+                EXPECT_FALSE(results[1].success);
+                ASSERT_EQ(results[1].diagnostics.size(), 1);
+                EXPECT_EQ(results[1].diagnostics[0].message, "Cannot open file " + path);
+            }
+
+            TEST_F(DriverTests, ErrorsDoNotStopOtherFiles) {
+                Driver driver(2);
+                auto results = driver.compile_files({WriteSource("broken", "var a = 1;\nvar a = b;\nconst c = 1.e;"),
+                                                     WriteSource("semantic", "var a = 1;\nvar a = b;"),
+                                                     WriteSource("valid", "var a = 1;")});
+
+                ASSERT_EQ(results.size(), 3);
+
+                // Semantic analysis is skipped after syntax errors
+                EXPECT_FALSE(results[0].success);
+                ASSERT_EQ(results[0].diagnostics.size(), 1);
+                EXPECT_EQ(results[0].diagnostics[0].line, 3);
+                EXPECT_EQ(results[0].diagnostics[0].column, 11);
+                EXPECT_EQ(results[0].diagnostics[0].message, "Invalid float: 1.e");
+
+                EXPECT_FALSE(results[1].success);
+                EXPECT_EQ(results[1].diagnostics.size(), 2);
+
+                EXPECT_TRUE(results[2].success);
+            }
+        }// namespace
+    }    // namespace tests
+}// namespace soma
@@ -0,0 +1,125 @@
+/**
+ * Tests for the tree-walking evaluator
+ * @file: evaluator_tests.cpp
+ * @date: 17.10.2026
+ */
+
+#include <gtest/gtest.h>
+#include <memory>
+#include <string>
+
+#include "../src/compilation_pipeline.h"
+#include "../src/evaluator.cpp"
+
+namespace soma {
+    namespace tests {
+        namespace {
+            class EvaluatorTests : public ::testing::Test {
+            protected:
+                std::unique_ptr<CompilationPipeline> pipeline;
+                std::unique_ptr<Evaluator> evaluator;
+
+            public:
+                /**
+                 * Runs the input, optimised when requested in the same order as the driver
+                 */
+                void Run(const std::string &input, bool optimise = false) {
+                    pipeline.reset(new CompilationPipeline());
+                    ASSERT_TRUE(pipeline->analyze(input)) << "Input: " << input;
+
+                    if (optimise) {
+                        pipeline->optimize();
+                        pipeline->share_values();
+                    }
+
+                    evaluator.reset(new Evaluator(pipeline->get_context(), pipeline->get_slot_count()));
+                    evaluator->run();
+                }
+
+                /**
+                 * @return text of the final value of the variable, empty when it has none
+                 */
+                std::string Value(const std::string &name) {
+                    const RuntimeValue *value = evaluator->find_variable(name.data(), name.size());
+
+                    return value == nullptr ? "" : value->get_text();
+                }
+            };
+
+            TEST_F(EvaluatorTests, IntegerArithmetic) {
+                Run("var a = 7;"
+                    "var b = a * 3 - 1;"
+                    "var c = 9223372036854775807 + 1;"
+                    "a = b + a;");
+
+                EXPECT_EQ(Value("a"), "27");
+                EXPECT_EQ(Value("b"), "20");
+                EXPECT_EQ(Value("c"), "-9223372036854775808");
+                EXPECT_EQ(evaluator->find_variable("a", 1)->type, SYM_TABLE_TYPE_INT);
+            }
+
+            TEST_F(EvaluatorTests, FloatArithmetic) {
+                // Division always computes in double, an integer operand of a float operator is converted
+                Run("var a = 7 / 2;"
+                    "var b = 1.5 * 2;"
+                    "var c = 0.1 + 0.2;"
+                    "var d = 1 / 0;");
+
+                EXPECT_EQ(Value("a"), "3.5");
+                EXPECT_EQ(Value("b"), "3");
+                EXPECT_EQ(Value("c"), "0.30000000000000004");
+                EXPECT_EQ(Value("d"), "inf");
+                EXPECT_EQ(evaluator->find_variable("b", 1)->type, SYM_TABLE_TYPE_FLOAT);
+            }
+
+            TEST_F(EvaluatorTests, Reassignment) {
+                Run("var a = 1;"
+                    "var b = a;"
+                    "a = a / 4;"
+                    "b = a + b;");
+
+                EXPECT_EQ(Value("a"), "0.25");
+                EXPECT_EQ(Value("b"), "1.25");
+            }
+
+            TEST_F(EvaluatorTests, Blocks) {
+                // A block sees the variables around it, its own declarations shadow them until it ends
+                Run("var a = 1;"
+                    "{ var a = 10; var b = a + 1; }"
+                    "{ a = a + 2; }");
+
+                EXPECT_EQ(Value("a"), "3");
+                EXPECT_EQ(Value("b"), "");
+            }
+
+            TEST_F(EvaluatorTests, UnknownVariables) {
+                Run("const a = 1;"
+                    "var b = a;");
+
+                EXPECT_EQ(Value("b"), "1");
+                EXPECT_EQ(Value("c"), "");
+                EXPECT_EQ(evaluator->find_variable("c", 1), nullptr);
+            }
+
+            TEST_F(EvaluatorTests, OptimisedProgramsAgree) {
+                const char *inputs[] = {
+                        "var a = 5; var b = a * a + a * a; a = b - 1;",
+                        "var x = 3; var y = x + 1 + x + 2; var z = y / 2 + x * 0.5;",
+                        "const k = 4; var a = k * 2; { var t = a + k; a = t * t; } var b = a - 1.5;",
+                        "var a = 1.5; var b = a * 1 - 0; a = 2; b = a + b + a;",
+                        "var a = 2; var b = a; a = a * 1000000007 * 1000000007; b = b + a;",
+                };
+
+                for (const char *input: inputs) {
+                    Run(input);
+                    std::string expected[] = {Value("a"), Value("b"), Value("x"), Value("y"), Value("z")};
+
+                    Run(input, true);
+                    std::string actual[] = {Value("a"), Value("b"), Value("x"), Value("y"), Value("z")};
+
+                    for (size_t i = 0; i < 5; i++) EXPECT_EQ(actual[i], expected[i]) << "Input: " << input;
+                }
+            }
+        }// namespace
+    }    // namespace tests
+}// namespace soma
@@ -0,0 +1,254 @@
+/**
+ * Tests for the incremental analysis of edited sources
+ * @file: incremental_analysis_tests.cpp
+ * @date: 17.10.2026
+ */
+
+#include <gtest/gtest.h>
+#include <cstdint>
+#include <random>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include "../src/compilation_context.h"
+#include "../src/compilation_pipeline.h"
+#include "../src/lexical_analysis.h"
+#include "../src/syntax_analysis.h"
+#include "../src/semantic_analysis.h"
+#include "../src/incremental_analysis.cpp"
+
+namespace soma {
+    namespace tests {
+        namespace {
+            class IncrementalAnalysisTests : public ::testing::Test {
+            public:
+                static std::vector<std::string> GetErrors(const std::vector<Diagnostic> &diagnostics) {
+                    std::vector<std::string> errors;
+                    for (auto &diagnostic: diagnostics) {
+                        errors.push_back(std::to_string(diagnostic.code) + " " + std::to_string(diagnostic.line) +
+                                         ":" + std::to_string(diagnostic.column) + ": " + diagnostic.message);
+                    }
+
+                    return errors;
+                }
+
+                /**
+                 * Compares the incremental errors with those of the driver, and the types with an analysis of the whole
+                 * text that checks it despite errors
+                 */
+                static void CheckMatchesFullAnalysis(const IncrementalAnalysis &analysis,
+                                                     const std::vector<std::string> &names) {
+                    CompilationPipeline pipeline;
+                    pipeline.analyze(analysis.get_text());
+
+                    ASSERT_EQ(GetErrors(analysis.get_diagnostics()),
+                              GetErrors(pipeline.get_context()->get_diagnostics()->get_diagnostics()))
+                            << "Input: " << analysis.get_text();
+
+                    std::istringstream stream(analysis.get_text());
+                    CompilationContext context(SIZE_MAX);
+                    LexicalAnalysis lexical_analysis(&stream);
+                    SyntaxAnalysis syntax_analysis(&lexical_analysis, &context);
+                    SemanticAnalysis semantic_analysis(&context);
+                    semantic_analysis.analyze_tree(syntax_analysis.build_tree());
+
+                    for (auto &name: names) {
+                        auto entry = context.get_symbol_table()->find(
+                                context.get_interner()->find(name.data(), name.size()));
+
+                        ASSERT_EQ(analysis.get_type(name), entry != nullptr ? entry->data.get_type()
+                                                                            : SYM_TABLE_TYPE_UNKNOWN)
+                                << "Symbol " << name << " type mismatch. Input: " << analysis.get_text();
+                    }
+                }
+
+                static void Replace(IncrementalAnalysis &analysis, const std::string &search,
+                                    const std::string &replacement) {
+                    size_t offset = analysis.get_text().find(search);
+                    ASSERT_NE(offset, std::string::npos) << search;
+
+                    analysis.apply_edit(offset, search.size(), replacement);
+                }
+            };
+
+            TEST_F(IncrementalAnalysisTests, Empty) {
+                IncrementalAnalysis analysis("");
+                EXPECT_EQ(analysis.get_statement_count(), 0);
+                CheckMatchesFullAnalysis(analysis, {});
+
+                analysis.apply_edit(0, 0, "var a = 1;");
+                EXPECT_EQ(analysis.get_statement_count(), 1);
+                EXPECT_EQ(analysis.get_type("a"), SYM_TABLE_TYPE_INT);
+                CheckMatchesFullAnalysis(analysis, {"a"});
+
+                analysis.apply_edit(0, analysis.get_text().size(), " \n ");
+                EXPECT_EQ(analysis.get_statement_count(), 0);
+                CheckMatchesFullAnalysis(analysis, {"a"});
+            }
+
+            TEST_F(IncrementalAnalysisTests, Edits) {
+                IncrementalAnalysis analysis("var a = 1;\n"
+                                             "var b = a * 2;\n"
+                                             "{\n"
+                                             "    var c = b / 4;\n"
+                                             "    a = c;\n"
+                                             "}\n"
+                                             "const d = b + 1;\n");
+                std::vector<std::string> names = {"a", "b", "c", "d"};
+
+                CheckMatchesFullAnalysis(analysis, names);
+                EXPECT_EQ(analysis.get_statement_count(), 4);
+                EXPECT_EQ(analysis.get_type("a"), SYM_TABLE_TYPE_FLOAT);
+
+                // Splitting and joining statements
+                Replace(analysis, "2;", "2");
+                CheckMatchesFullAnalysis(analysis, names);
+                Replace(analysis, "* 2", "* 2;");
+                CheckMatchesFullAnalysis(analysis, names);
+                Replace(analysis, "}\n", "");
+                CheckMatchesFullAnalysis(analysis, names);
+                Replace(analysis, "a = c;\n", "a = c;\n}\n");
+                CheckMatchesFullAnalysis(analysis, names);
+
+                // Errors of the lexical, syntax and semantic analysis
+                Replace(analysis, "b / 4", "b / 4.e");
+                CheckMatchesFullAnalysis(analysis, names);
+                Replace(analysis, "var a", "var # a");
+                CheckMatchesFullAnalysis(analysis, names);
+                Replace(analysis, "var # a", "const a");
+                CheckMatchesFullAnalysis(analysis, names);
+                Replace(analysis, "const d", "d");
+                CheckMatchesFullAnalysis(analysis, names);
+
+                // Edits spanning several statements and the end of the text
+                Replace(analysis, "2;\n{", "2; var d = 1; {");
+                CheckMatchesFullAnalysis(analysis, names);
+                analysis.apply_edit(analysis.get_text().size(), 0, "var e = d");
+                CheckMatchesFullAnalysis(analysis, names);
+                analysis.apply_edit(4, analysis.get_text().size() - 8, "");
+                CheckMatchesFullAnalysis(analysis, names);
+            }
+
+            TEST_F(IncrementalAnalysisTests, RandomEdits) {
+                const std::vector<std::string> pieces = {
+                        "var ", "const ", "a", "b", "c", " = ", "1", "2.5", "1.e", " + ", " * ", " / ",
+                        ";",    "{",      "}", "(", ")", "\n", " ", "#",   "x1",
+                };
+                std::vector<std::string> names = {"a", "b", "c", "x1"};
+
+                std::mt19937 random(20261017);
+                IncrementalAnalysis analysis("var a = 1;\nvar b = a + 2.5;\n{ var c = b; a = c; }\nb = a * b;\n");
+
+                for (int i = 0; i < 2000; i++) {
+                    const std::string &text = analysis.get_text();
+                    size_t offset = random() % (text.size() + 1);
+                    size_t length = random() % 3 == 0 ? random() % 6 : 0;
+
+                    std::string replacement;
+                    for (size_t count = random() % 4; count > 0; count--)
+                        replacement += pieces[random() % pieces.size()];
+
+                    analysis.apply_edit(offset, length, replacement);
+                    CheckMatchesFullAnalysis(analysis, names);
+                    if (HasFatalFailure()) return;
+                }
+            }
+
+            TEST_F(IncrementalAnalysisTests, LocalEdits) {
+                std::string text;
+                for (int i = 0; i < 1000; i++) text += "var v" + std::to_string(i) + " = " + std::to_string(i) + ";\n";
+                text += "var w = v500 * 2;\n";
+
+                IncrementalAnalysis analysis(text);
+                EXPECT_EQ(analysis.get_statement_count(), 1001);
+
+                // Only the edited statement is parsed again, and only it is checked while the type stays the same
+                Replace(analysis, "= 500;", "= 501;");
+                EXPECT_EQ(analysis.get_reparsed_count(), 1);
+                EXPECT_EQ(analysis.get_reanalyzed_count(), 1);
+                CheckMatchesFullAnalysis(analysis, {"v500", "w"});
+
+                // A changed type is checked again where the variable is used
+                Replace(analysis, "= 501;", "= 5.5;");
+                EXPECT_EQ(analysis.get_reparsed_count(), 1);
+                EXPECT_EQ(analysis.get_reanalyzed_count(), 2);
+                EXPECT_EQ(analysis.get_type("w"), SYM_TABLE_TYPE_FLOAT);
+                CheckMatchesFullAnalysis(analysis, {"v500", "w"});
+
+                // Lines inserted before an error move it without parsing the statement again
+                Replace(analysis, "v999 = 999", "v999 = v1000");
+                CheckMatchesFullAnalysis(analysis, {"v999"});
+                analysis.apply_edit(0, 0, "\n\n");
+                EXPECT_EQ(analysis.get_reparsed_count(), 1);
+                EXPECT_EQ(analysis.get_reanalyzed_count(), 1);
+                CheckMatchesFullAnalysis(analysis, {"v999"});
+
+                // Removing a statement keeps the ones around it, and checks only the next one using its names
+                Replace(analysis, "\nvar v10 = 10;", "");
+                EXPECT_EQ(analysis.get_reparsed_count(), 0);
+                EXPECT_EQ(analysis.get_reanalyzed_count(), 0);
+                EXPECT_EQ(analysis.get_statement_count(), 1000);
+                CheckMatchesFullAnalysis(analysis, {"v10", "v11"});
+
+                Replace(analysis, "\nvar v500 = 5.5;", "");
+                EXPECT_EQ(analysis.get_reparsed_count(), 0);
+                EXPECT_EQ(analysis.get_reanalyzed_count(), 1);
+                CheckMatchesFullAnalysis(analysis, {"v500", "w"});
+            }
+
+            TEST_F(IncrementalAnalysisTests, DiagnosticsPolicy) {
+                // Semantic errors are left out while the text has syntax errors
+                IncrementalAnalysis analysis("var a = b;\nvar c = 1;\n");
+                EXPECT_EQ(analysis.get_diagnostics().size(), 1);
+                Replace(analysis, "c = 1;", "c = 1");
+                EXPECT_EQ(analysis.get_diagnostics().size(), 1);
+                EXPECT_EQ(analysis.get_diagnostics()[0].code, SYNTAX_ANALYSIS_ERROR_CODE);
+                EXPECT_EQ(analysis.get_type("c"), SYM_TABLE_TYPE_UNKNOWN);
+                EXPECT_EQ(analysis.get_type("a"), SYM_TABLE_TYPE_UNKNOWN);
+                CheckMatchesFullAnalysis(analysis, {"a", "c"});
+
+                // Errors past the limit are dropped in the order they were reported, lexical errors first
+                std::string text;
+                for (int i = 0; i < 150; i++) text += "var v" + std::to_string(i) + " = w;\n";
+                analysis.apply_edit(0, analysis.get_text().size(), text);
+                EXPECT_EQ(analysis.get_diagnostics().size(), DIAGNOSTICS_DEFAULT_LIMIT);
+                CheckMatchesFullAnalysis(analysis, {"v0", "v149"});
+
+                Replace(analysis, "v140 = w;", "v140 = w");
+                for (int i = 0; i < 120; i++) analysis.apply_edit(analysis.get_text().size(), 0, "var x = 1.e;\n");
+                EXPECT_EQ(analysis.get_diagnostics().size(), DIAGNOSTICS_DEFAULT_LIMIT);
+                CheckMatchesFullAnalysis(analysis, {"v0", "x"});
+
+                Replace(analysis, "v140 = w", "v140 = w;");
+                CheckMatchesFullAnalysis(analysis, {"v0", "x"});
+            }
+
+            TEST_F(IncrementalAnalysisTests, ReclaimsReplacedTrees) {
+                std::string text;
+                for (int i = 0; i < 100; i++)
+                    text += "var v" + std::to_string(i) + " = v0 * " + std::to_string(i) + ";\n";
+
+                IncrementalAnalysis analysis(text);
+                size_t initial_bytes = analysis.get_allocated_bytes();
+
+                // Every keystroke leaves the tree of the statement it replaced in the arena until it is compacted
+                size_t offset = analysis.get_text().find("* 50;") + 2;
+                for (int i = 0; i < 20000; i++) {
+                    if (i % 2 == 0) analysis.apply_edit(offset, 0, "1");
+                    else
+                        analysis.apply_edit(offset, 1, "");
+
+                    ASSERT_LE(analysis.get_allocated_bytes(), initial_bytes + INCREMENTAL_ANALYSIS_DEAD_LIMIT + 1024);
+                }
+
+                CheckMatchesFullAnalysis(analysis, {"v0", "v50"});
+
+                // Edits after a compaction are parsed incrementally again
+                analysis.apply_edit(offset, 0, "2");
+                EXPECT_EQ(analysis.get_reparsed_count(), 1);
+                CheckMatchesFullAnalysis(analysis, {"v0", "v50"});
+            }
+        }// namespace
+    }// namespace tests
+}// namespace soma
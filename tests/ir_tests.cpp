@@ -0,0 +1,112 @@
+/**
+ * Tests for the intermediate representation and its lowering
+ * @file: ir_tests.cpp
+ * @date: 17.10.2026
+ */
+
+#include <gtest/gtest.h>
+#include <string>
+
+#include "../src/compilation_pipeline.h"
+#include "../src/ir.cpp"
+#include "../src/ir_lowering.cpp"
+
+namespace soma {
+    namespace tests {
+        namespace {
+            class IrTests : public ::testing::Test {
+            protected:
+                IrProgram program;
+
+            public:
+                /**
+                 * Lowers the input without optimising it, only equal subexpressions are shared
+                 * @return dump of the program
+                 */
+                std::string Lower(const std::string &input) {
+                    CompilationPipeline pipeline;
+                    EXPECT_TRUE(pipeline.analyze(input)) << "Input: " << input;
+
+                    pipeline.share_values();
+                    program = pipeline.lower();
+
+                    return program.dump();
+                }
+            };
+
+            TEST_F(IrTests, Empty) {
+                EXPECT_EQ(Lower(""), "");
+                EXPECT_EQ(program.register_count, 0);
+            }
+
+            TEST_F(IrTests, Assignments) {
+                EXPECT_EQ(Lower("var a = 1;"
+                                "var b = a * 2 + 3;"
+                                "b = a;"
+                                "1 + 2;"),
+                          "v0 = const.i 1\n"
+                          "t2 = const.i 2\n"
+                          "t3 = mul.i v0, t2\n"
+                          "t4 = const.i 3\n"
+                          "v1 = add.i t3, t4\n"
+                          "v1 = move v0\n");
+
+                EXPECT_EQ(program.variable_count, 2);
+                EXPECT_EQ(program.register_count, 5);
+                EXPECT_EQ(program.variable_types, std::vector<SYM_TABLE_DATA_TYPE>({SYM_TABLE_TYPE_INT,
+                                                                                     SYM_TABLE_TYPE_INT}));
+            }
+
+            TEST_F(IrTests, TypedOperations) {
+                // Integer operands of float operators are converted once per value, division always produces a float
+                EXPECT_EQ(Lower("var a = 2;"
+                                "var b = a * 1.5 - a;"
+                                "var c = a / a;"
+                                "a = 3;"
+                                "c = a / 2;"),
+                          "v0 = const.i 2\n"
+                          "t3 = const.f 1.5\n"
+                          "t4 = itof v0\n"
+                          "t5 = mul.f t4, t3\n"
+                          "v1 = sub.f t5, t4\n"
+                          "v2 = div.f t4, t4\n"
+                          "v0 = const.i 3\n"
+                          "t6 = const.i 2\n"
+                          "t7 = itof v0\n"
+                          "t8 = itof t6\n"
+                          "v2 = div.f t7, t8\n");
+
+                EXPECT_EQ(program.variable_types, std::vector<SYM_TABLE_DATA_TYPE>({SYM_TABLE_TYPE_INT,
+                                                                                     SYM_TABLE_TYPE_FLOAT,
+                                                                                     SYM_TABLE_TYPE_FLOAT}));
+            }
+
+            TEST_F(IrTests, SharedExpressions) {
+                // Shared expressions are computed once, a reassignment starts a new value
+                EXPECT_EQ(Lower("var a = 1;"
+                                "var b = (a + 1) * (a + 1);"
+                                "var c = a + 1;"
+                                "a = 5;"
+                                "var d = a + 1;"),
+                          "v0 = const.i 1\n"
+                          "t4 = const.i 1\n"
+                          "t5 = add.i v0, t4\n"
+                          "v1 = mul.i t5, t5\n"
+                          "v2 = move t5\n"
+                          "v0 = const.i 5\n"
+                          "v3 = add.i v0, t4\n");
+            }
+
+            TEST_F(IrTests, Blocks) {
+                EXPECT_EQ(Lower("var a = 1;"
+                                "{ var a = 2.5; var b = a; }"
+                                "a = a + 1;"),
+                          "v0 = const.i 1\n"
+                          "v1 = const.f 2.5\n"
+                          "v2 = move v1\n"
+                          "t3 = const.i 1\n"
+                          "v0 = add.i v0, t3\n");
+            }
+        }// namespace
+    }    // namespace tests
+}// namespace soma
@@ -6,49 +6,70 @@
 
 #include <gtest/gtest.h>
 
+#include "../src/diagnostics.h"
+#include "../src/source_buffer.cpp"
 #include "../src/lexical_analysis.cpp"
 
 namespace soma {
     namespace tests {
         namespace {
+            struct ExpectedToken {
+                std::string value;
+                LEXICAL_TOKEN_TYPE type;
+
+                ExpectedToken(std::string value, LEXICAL_TOKEN_TYPE type) : value(std::move(value)), type(type) {}
+            };
+
             class LexicalAnalysisTests : public ::testing::Test {
             protected:
+                std::vector<std::string> actual_values;
                 std::vector<LexicalToken> actual_tokens;
                 std::istringstream input_stream;
 
             public:
                 LexicalAnalysisTests() {
+                    actual_values = std::vector<std::string>();
                     actual_tokens = std::vector<LexicalToken>();
                     input_stream = std::istringstream();
                 }
 
                 void TearDown() override {
+                    actual_values.clear();
                     actual_tokens.clear();
                     input_stream.clear();
                 }
 
-                void ProcessInput(const std::string &input, const std::vector<LexicalToken> &expected_tokens) {
+                void ProcessInput(const std::string &input, const std::vector<ExpectedToken> &expected_tokens,
+                                  Diagnostics *diagnostics = nullptr) {
                     input_stream = std::istringstream(input);
                     LexicalAnalysis analysis(&input_stream);
-                    LexicalToken *token = analysis.get_token();
+                    analysis.set_diagnostics(diagnostics);
+                    actual_tokens = analysis.tokenize();
+                    actual_tokens.pop_back();
 
-                    while (token != nullptr && token->get_type() != LEX_TOKEN_EOF) {
-                        actual_tokens.push_back(*token);
-                        token = analysis.get_token();
-                    }
+                    actual_values.clear();
+                    for (auto token: actual_tokens) actual_values.push_back(analysis.get_value(token));
 
                     EXPECT_EQ(actual_tokens.size(), expected_tokens.size()) << "Input: " << input;
-                    for (auto expected_token: expected_tokens) {
-                        auto actual_token = actual_tokens.front();
-
-                        if (expected_token.get_type())
-                            EXPECT_EQ(actual_token.get_type(), expected_token.get_type()) << "Input: " << input;
+                    for (size_t i = 0; i < expected_tokens.size() && i < actual_tokens.size(); i++) {
+                        auto expected_token = expected_tokens[i];
 
-                        EXPECT_EQ(actual_token.get_value(), expected_token.get_value()) << "Input: " << input;
+                        if (expected_token.type) {
+                            EXPECT_EQ(actual_tokens[i].type, expected_token.type) << "Input: " << input;
+                        }
 
-                        actual_tokens.erase(actual_tokens.begin());
+                        EXPECT_EQ(actual_values[i], expected_token.value) << "Input: " << input;
                     }
                 }
+
+                void ProcessInvalidInput(const std::string &input, const std::vector<ExpectedToken> &expected_tokens,
+                                         const std::string &expected_error) {
+                    Diagnostics diagnostics;
+                    ProcessInput(input, expected_tokens, &diagnostics);
+
+                    ASSERT_EQ(diagnostics.size(), 1) << "Input: " << input;
+                    EXPECT_EQ(diagnostics.get_diagnostics()[0].message, expected_error) << "Input: " << input;
+                }
             };
 
             TEST_F(LexicalAnalysisTests, Empty) {
@@ -64,111 +85,191 @@ namespace soma {
             }
 
             TEST_F(LexicalAnalysisTests, Brackets) {
-                ProcessInput("()", {LexicalToken("(", LEX_TOKEN_LEFT_PARENTHESIS),
-                                    LexicalToken(")", LEX_TOKEN_RIGHT_PARENTHESIS)});
-
-                ProcessInput("[]", {LexicalToken("[", LEX_TOKEN_LEFT_SQUARE_BRACKET),
-                                    LexicalToken("]", LEX_TOKEN_RIGHT_SQUARE_BRACKET)});
-
-                ProcessInput("{}", {LexicalToken("{", LEX_TOKEN_LEFT_CURLY_BRACKET),
-                                    LexicalToken("}", LEX_TOKEN_RIGHT_CURLY_BRACKET)});
-
-                ProcessInput("(())", {LexicalToken("(", LEX_TOKEN_LEFT_PARENTHESIS),
-                                      LexicalToken("(", LEX_TOKEN_LEFT_PARENTHESIS),
-                                      LexicalToken(")", LEX_TOKEN_RIGHT_PARENTHESIS),
-                                      LexicalToken(")", LEX_TOKEN_RIGHT_PARENTHESIS)});
-
-                ProcessInput("([])", {LexicalToken("(", LEX_TOKEN_LEFT_PARENTHESIS),
-                                      LexicalToken("[", LEX_TOKEN_LEFT_SQUARE_BRACKET),
-                                      LexicalToken("]", LEX_TOKEN_RIGHT_SQUARE_BRACKET),
-                                      LexicalToken(")", LEX_TOKEN_RIGHT_PARENTHESIS)});
-
-                ProcessInput("([{}])", {LexicalToken("(", LEX_TOKEN_LEFT_PARENTHESIS),
-                                        LexicalToken("[", LEX_TOKEN_LEFT_SQUARE_BRACKET),
-                                        LexicalToken("{", LEX_TOKEN_LEFT_CURLY_BRACKET),
-                                        LexicalToken("}", LEX_TOKEN_RIGHT_CURLY_BRACKET),
-                                        LexicalToken("]", LEX_TOKEN_RIGHT_SQUARE_BRACKET),
-                                        LexicalToken(")", LEX_TOKEN_RIGHT_PARENTHESIS)});
-
-                ProcessInput(" ( [ \n ] ) ", {LexicalToken("(", LEX_TOKEN_LEFT_PARENTHESIS),
-                                              LexicalToken("[", LEX_TOKEN_LEFT_SQUARE_BRACKET),
-                                              LexicalToken("]", LEX_TOKEN_RIGHT_SQUARE_BRACKET),
-                                              LexicalToken(")", LEX_TOKEN_RIGHT_PARENTHESIS)});
+                ProcessInput("()", {ExpectedToken("(", LEX_TOKEN_LEFT_PARENTHESIS),
+                                    ExpectedToken(")", LEX_TOKEN_RIGHT_PARENTHESIS)});
+
+                ProcessInput("[]", {ExpectedToken("[", LEX_TOKEN_LEFT_SQUARE_BRACKET),
+                                    ExpectedToken("]", LEX_TOKEN_RIGHT_SQUARE_BRACKET)});
+
+                ProcessInput("{}", {ExpectedToken("{", LEX_TOKEN_LEFT_CURLY_BRACKET),
+                                    ExpectedToken("}", LEX_TOKEN_RIGHT_CURLY_BRACKET)});
+
+                ProcessInput("(())", {ExpectedToken("(", LEX_TOKEN_LEFT_PARENTHESIS),
+                                      ExpectedToken("(", LEX_TOKEN_LEFT_PARENTHESIS),
+                                      ExpectedToken(")", LEX_TOKEN_RIGHT_PARENTHESIS),
+                                      ExpectedToken(")", LEX_TOKEN_RIGHT_PARENTHESIS)});
+
+                ProcessInput("([])", {ExpectedToken("(", LEX_TOKEN_LEFT_PARENTHESIS),
+                                      ExpectedToken("[", LEX_TOKEN_LEFT_SQUARE_BRACKET),
+                                      ExpectedToken("]", LEX_TOKEN_RIGHT_SQUARE_BRACKET),
+                                      ExpectedToken(")", LEX_TOKEN_RIGHT_PARENTHESIS)});
+
+                ProcessInput("([{}])", {ExpectedToken("(", LEX_TOKEN_LEFT_PARENTHESIS),
+                                        ExpectedToken("[", LEX_TOKEN_LEFT_SQUARE_BRACKET),
+                                        ExpectedToken("{", LEX_TOKEN_LEFT_CURLY_BRACKET),
+                                        ExpectedToken("}", LEX_TOKEN_RIGHT_CURLY_BRACKET),
+                                        ExpectedToken("]", LEX_TOKEN_RIGHT_SQUARE_BRACKET),
+                                        ExpectedToken(")", LEX_TOKEN_RIGHT_PARENTHESIS)});
+
+                ProcessInput(" ( [ \n ] ) ", {ExpectedToken("(", LEX_TOKEN_LEFT_PARENTHESIS),
+                                              ExpectedToken("[", LEX_TOKEN_LEFT_SQUARE_BRACKET),
+                                              ExpectedToken("]", LEX_TOKEN_RIGHT_SQUARE_BRACKET),
+                                              ExpectedToken(")", LEX_TOKEN_RIGHT_PARENTHESIS)});
             }
 
             TEST_F(LexicalAnalysisTests, Operators) {
-                ProcessInput("=", {LexicalToken("=", LEX_TOKEN_ASSIGN)});
+                ProcessInput("=", {ExpectedToken("=", LEX_TOKEN_ASSIGN)});
 
-                ProcessInput("+", {LexicalToken("+", LEX_TOKEN_PLUS)});
+                ProcessInput("+", {ExpectedToken("+", LEX_TOKEN_PLUS)});
 
-                ProcessInput("-", {LexicalToken("-", LEX_TOKEN_MINUS)});
+                ProcessInput("-", {ExpectedToken("-", LEX_TOKEN_MINUS)});
 
-                ProcessInput("*", {LexicalToken("*", LEX_TOKEN_MULTIPLY)});
+                ProcessInput("*", {ExpectedToken("*", LEX_TOKEN_MULTIPLY)});
 
-                ProcessInput("/", {LexicalToken("/", LEX_TOKEN_DIVIDE)});
+                ProcessInput("/", {ExpectedToken("/", LEX_TOKEN_DIVIDE)});
 
-                ProcessInput("/ *", {LexicalToken("/", LEX_TOKEN_DIVIDE), LexicalToken("*", LEX_TOKEN_MULTIPLY)});
+                ProcessInput("/ *", {ExpectedToken("/", LEX_TOKEN_DIVIDE), ExpectedToken("*", LEX_TOKEN_MULTIPLY)});
 
                 ProcessInput("/ *  = -  \n+",
-                             {LexicalToken("/", LEX_TOKEN_DIVIDE), LexicalToken("*", LEX_TOKEN_MULTIPLY),
-                              LexicalToken("=", LEX_TOKEN_ASSIGN), LexicalToken("-", LEX_TOKEN_MINUS),
-                              LexicalToken("+", LEX_TOKEN_PLUS)});
+                             {ExpectedToken("/", LEX_TOKEN_DIVIDE), ExpectedToken("*", LEX_TOKEN_MULTIPLY),
+                              ExpectedToken("=", LEX_TOKEN_ASSIGN), ExpectedToken("-", LEX_TOKEN_MINUS),
+                              ExpectedToken("+", LEX_TOKEN_PLUS)});
 
-                EXPECT_DEATH(ProcessInput("+*+", {}), "Unknown operator: .*");
+                ProcessInvalidInput("+*+", {ExpectedToken("+*+", LEX_TOKEN_ERROR)}, "Unknown operator: +*+");
 
-                EXPECT_DEATH(ProcessInput("/-", {}), "Unknown operator: .*");
+                ProcessInvalidInput("1 /- 2",
+                                    {ExpectedToken("1", LEX_TOKEN_INTEGER_LITERAL),
+                                     ExpectedToken("/-", LEX_TOKEN_ERROR),
+                                     ExpectedToken("2", LEX_TOKEN_INTEGER_LITERAL)},
+                                    "Unknown operator: /-");
             }
 
             TEST_F(LexicalAnalysisTests, Integers) {
-                ProcessInput("1", {LexicalToken("1", LEX_TOKEN_INTEGER_LITERAL)});
+                ProcessInput("1", {ExpectedToken("1", LEX_TOKEN_INTEGER_LITERAL)});
 
-                ProcessInput("1 2", {LexicalToken("1", LEX_TOKEN_INTEGER_LITERAL),
-                                     LexicalToken("2", LEX_TOKEN_INTEGER_LITERAL)});
+                ProcessInput("1 2", {ExpectedToken("1", LEX_TOKEN_INTEGER_LITERAL),
+                                     ExpectedToken("2", LEX_TOKEN_INTEGER_LITERAL)});
 
-                ProcessInput("1 234", {LexicalToken("1", LEX_TOKEN_INTEGER_LITERAL),
-                                       LexicalToken("234", LEX_TOKEN_INTEGER_LITERAL)});
+                ProcessInput("1 234", {ExpectedToken("1", LEX_TOKEN_INTEGER_LITERAL),
+                                       ExpectedToken("234", LEX_TOKEN_INTEGER_LITERAL)});
             }
 
             TEST_F(LexicalAnalysisTests, Floats) {
                 ProcessInput("1.1;",
-                             {LexicalToken("1.1", LEX_TOKEN_FLOAT_LITERAL), LexicalToken(";", LEX_TOKEN_SEMICOLON)});
+                             {ExpectedToken("1.1", LEX_TOKEN_FLOAT_LITERAL), ExpectedToken(";", LEX_TOKEN_SEMICOLON)});
+
+                ProcessInput("1.1 2e1", {ExpectedToken("1.1", LEX_TOKEN_FLOAT_LITERAL),
+                                         ExpectedToken("2e1", LEX_TOKEN_FLOAT_LITERAL)});
+
+                ProcessInput("1.1 2e1 3e-12 4.52e+13", {ExpectedToken("1.1", LEX_TOKEN_FLOAT_LITERAL),
+                                                        ExpectedToken("2e1", LEX_TOKEN_FLOAT_LITERAL),
+                                                        ExpectedToken("3e-12", LEX_TOKEN_FLOAT_LITERAL),
+                                                        ExpectedToken("4.52e+13", LEX_TOKEN_FLOAT_LITERAL)});
+
+                ProcessInvalidInput("1.1e", {ExpectedToken("1.1e", LEX_TOKEN_ERROR)}, "Invalid float: 1.1e");
 
-                ProcessInput("1.1 2e1", {LexicalToken("1.1", LEX_TOKEN_FLOAT_LITERAL),
-                                         LexicalToken("2e1", LEX_TOKEN_FLOAT_LITERAL)});
+                ProcessInvalidInput("1.1e-", {ExpectedToken("1.1e-", LEX_TOKEN_ERROR)}, "Invalid float: 1.1e-");
 
-                ProcessInput("1.1 2e1 3e-12 4.52e+13", {LexicalToken("1.1", LEX_TOKEN_FLOAT_LITERAL),
-                                                        LexicalToken("2e1", LEX_TOKEN_FLOAT_LITERAL),
-                                                        LexicalToken("3e-12", LEX_TOKEN_FLOAT_LITERAL),
-                                                        LexicalToken("4.52e+13", LEX_TOKEN_FLOAT_LITERAL)});
+                ProcessInvalidInput("1.1e+", {ExpectedToken("1.1e+", LEX_TOKEN_ERROR)}, "Invalid float: 1.1e+");
 
-                EXPECT_DEATH(ProcessInput("1.1e", {}), "Invalid float: .*");
+                ProcessInvalidInput("1.1e1.1",
+                                    {ExpectedToken("1.1e1.", LEX_TOKEN_ERROR),
+                                     ExpectedToken("1", LEX_TOKEN_INTEGER_LITERAL)},
+                                    "Invalid float: 1.1e1.");
 
-                EXPECT_DEATH(ProcessInput("1.1e-", {}), "Invalid float: .*");
+                ProcessInvalidInput("1..2",
+                                    {ExpectedToken("1..", LEX_TOKEN_ERROR),
+                                     ExpectedToken("2", LEX_TOKEN_INTEGER_LITERAL)},
+                                    "Invalid float: 1..");
 
-                EXPECT_DEATH(ProcessInput("1.1e+", {}), "Invalid float: .*");
+                ProcessInvalidInput("1e+;",
+                                    {ExpectedToken("1e+", LEX_TOKEN_ERROR), ExpectedToken(";", LEX_TOKEN_SEMICOLON)},
+                                    "Invalid float: 1e+");
 
-                EXPECT_DEATH(ProcessInput("1.1e1.1", {}), "Invalid float: .*");
+                ProcessInvalidInput("2.5e)", {ExpectedToken("2.5e", LEX_TOKEN_ERROR),
+                                              ExpectedToken(")", LEX_TOKEN_RIGHT_PARENTHESIS)},
+                                    "Invalid float: 2.5e");
+
+                ProcessInvalidInput("a # b",
+                                    {ExpectedToken("a", LEX_TOKEN_IDENTIFIER), ExpectedToken("#", LEX_TOKEN_ERROR),
+                                     ExpectedToken("b", LEX_TOKEN_IDENTIFIER)},
+                                    "Unexpected character: #");
+
+                ProcessInput("1.5+2.", {ExpectedToken("1.5", LEX_TOKEN_FLOAT_LITERAL),
+                                        ExpectedToken("+", LEX_TOKEN_PLUS),
+                                        ExpectedToken("2.", LEX_TOKEN_FLOAT_LITERAL)});
             }
 
             TEST_F(LexicalAnalysisTests, Keywords) {
                 ProcessInput("const a;",
-                             {LexicalToken("const", LEX_TOKEN_CONST), LexicalToken("a", LEX_TOKEN_IDENTIFIER),
-                              LexicalToken(";", LEX_TOKEN_SEMICOLON)});
+                             {ExpectedToken("const", LEX_TOKEN_CONST), ExpectedToken("a", LEX_TOKEN_IDENTIFIER),
+                              ExpectedToken(";", LEX_TOKEN_SEMICOLON)});
 
-                ProcessInput("var a;", {LexicalToken("var", LEX_TOKEN_VAR), LexicalToken("a", LEX_TOKEN_IDENTIFIER),
-                                        LexicalToken(";", LEX_TOKEN_SEMICOLON)});
+                ProcessInput("var a;", {ExpectedToken("var", LEX_TOKEN_VAR), ExpectedToken("a", LEX_TOKEN_IDENTIFIER),
+                                        ExpectedToken(";", LEX_TOKEN_SEMICOLON)});
             }
 
             TEST_F(LexicalAnalysisTests, Identifiers) {
-                ProcessInput("abc", {LexicalToken("abc", LEX_TOKEN_IDENTIFIER)});
+                ProcessInput("abc", {ExpectedToken("abc", LEX_TOKEN_IDENTIFIER)});
+
+                ProcessInput("abc_1", {ExpectedToken("abc_1", LEX_TOKEN_IDENTIFIER)});
+
+                ProcessInput("abc_1_a_a2f", {ExpectedToken("abc_1_a_a2f", LEX_TOKEN_IDENTIFIER)});
+
+                ProcessInput("vara", {ExpectedToken("vara", LEX_TOKEN_IDENTIFIER)});
+
+                ProcessInput("const_a1", {ExpectedToken("const_a1", LEX_TOKEN_IDENTIFIER)});
 
-                ProcessInput("abc_1", {LexicalToken("abc_1", LEX_TOKEN_IDENTIFIER)});
+                ProcessInput("cons vat Var constt", {ExpectedToken("cons", LEX_TOKEN_IDENTIFIER),
+                                                     ExpectedToken("vat", LEX_TOKEN_IDENTIFIER),
+                                                     ExpectedToken("Var", LEX_TOKEN_IDENTIFIER),
+                                                     ExpectedToken("constt", LEX_TOKEN_IDENTIFIER)});
+            }
+
+            TEST_F(LexicalAnalysisTests, BufferSlices) {
+                const char *input = "var ab = 12 +\n  1.5e2;";
+                SourceBuffer buffer(input, strlen(input));
+                LexicalAnalysis analysis(&buffer);
+
+                std::vector<LexicalToken> expected = {
+                        {LEX_TOKEN_VAR, 0, 3, 1, 1},
+                        {LEX_TOKEN_IDENTIFIER, 4, 2, 1, 5},
+                        {LEX_TOKEN_ASSIGN, 7, 1, 1, 8},
+                        {LEX_TOKEN_INTEGER_LITERAL, 9, 2, 1, 10},
+                        {LEX_TOKEN_PLUS, 12, 1, 1, 13},
+                        {LEX_TOKEN_FLOAT_LITERAL, 16, 5, 2, 3},
+                        {LEX_TOKEN_SEMICOLON, 21, 1, 2, 8},
+                        {LEX_TOKEN_EOF, 22, 0, 2, 9},
+                };
+
+                auto tokens = analysis.tokenize();
+
+                ASSERT_EQ(tokens.size(), expected.size());
+                for (size_t i = 0; i < expected.size(); i++) {
+                    EXPECT_EQ(tokens[i].type, expected[i].type);
+                    EXPECT_EQ(tokens[i].offset, expected[i].offset);
+                    EXPECT_EQ(tokens[i].length, expected[i].length);
+                    EXPECT_EQ(tokens[i].line, expected[i].line);
+                    EXPECT_EQ(tokens[i].column, expected[i].column);
+                }
+
+                EXPECT_EQ(analysis.get_token().type, LEX_TOKEN_EOF);
+            }
 
-                ProcessInput("abc_1_a_a2f", {LexicalToken("abc_1_a_a2f", LEX_TOKEN_IDENTIFIER)});
+            TEST_F(LexicalAnalysisTests, TooLongSource) {
+                // The text past the limit is never read, so the buffer only claims the length
+                const char *input = "var a = 1;";
+                SourceBuffer buffer(input, LEXICAL_ANALYSIS_MAX_LENGTH + 1);
+                LexicalAnalysis analysis(&buffer);
+                Diagnostics diagnostics;
+                analysis.set_diagnostics(&diagnostics);
 
-                ProcessInput("vara", {LexicalToken("vara", LEX_TOKEN_IDENTIFIER)});
+                auto tokens = analysis.tokenize();
 
-                ProcessInput("const_a1", {LexicalToken("const_a1", LEX_TOKEN_IDENTIFIER)});
+                ASSERT_EQ(tokens.size(), 1);
+                EXPECT_EQ(tokens[0].type, LEX_TOKEN_EOF);
+                ASSERT_EQ(diagnostics.size(), 1);
+                EXPECT_EQ(diagnostics.get_diagnostics()[0].message, "Source is longer than 4294967295 bytes");
             }
         }// namespace
     }    // namespace tests
@@ -0,0 +1,229 @@
+/**
+ * Tests for the optimiser
+ * @file: optimiser_tests.cpp
+ * @date: 17.10.2026
+ */
+
+#include <gtest/gtest.h>
+#include <map>
+#include <string>
+#include <vector>
+
+#include "../src/compilation_pipeline.h"
+#include "../src/optimiser.cpp"
+
+namespace soma {
+    namespace tests {
+        namespace {
+            class OptimiserTests : public ::testing::Test {
+            public:
+                /**
+                 * @return the assigned expressions of the optimised source in program order, operands and operators
+                 * separated by spaces
+                 */
+                static std::vector<std::string> Optimise(const std::string &input) {
+                    CompilationPipeline pipeline;
+                    EXPECT_TRUE(pipeline.analyze(input)) << "Input: " << input;
+
+                    Optimiser optimiser(pipeline.get_context());
+                    optimiser.optimize();
+
+                    std::vector<std::string> assigned;
+                    pipeline.get_syntax_tree()->process_tree_using(
+                            [&](SyntaxTree *statement) {
+                                if (statement->type != SYN_NODE_ASSIGNMENT) return;
+
+                                std::string expression;
+                                statement->right->process_tree_using(
+                                        [&](SyntaxTree *tree) {
+                                            if (!expression.empty()) expression += " ";
+                                            std::string text = tree->get_text();
+                                            expression += text.empty() ? "op" : text;
+                                        },
+                                        INORDER);
+                                assigned.push_back(expression);
+                            },
+                            PREORDER);
+
+                    return assigned;
+                }
+
+                /**
+                 * @return the statements left after removing the dead ones, blocks in braces
+                 */
+                static std::string Eliminate(const std::string &input, bool propagate, size_t expected_removed) {
+                    CompilationPipeline pipeline;
+                    EXPECT_TRUE(pipeline.analyze(input)) << "Input: " << input;
+                    auto syntax_tree = pipeline.get_syntax_tree();
+
+                    Optimiser optimiser(pipeline.get_context());
+                    if (propagate) optimiser.optimize();
+                    EXPECT_EQ(optimiser.eliminate_dead_stores(), expected_removed) << "Input: " << input;
+
+                    std::string statements;
+                    syntax_tree->process_tree_using(
+                            [&](SyntaxTree *statement) {
+                                if (statement->type == SYN_NODE_BLOCK) statements += "{ ";
+                                if (statement->type != SYN_NODE_ASSIGNMENT) return;
+
+                                if (statement->attributes & SYN_TREE_ATTR_CONSTANT) statements += "const ";
+                                else if (statement->attributes & SYN_TREE_ATTR_DECLARATION) statements += "var ";
+                                statements += statement->left->get_text() + " = " + Render(statement->right) + "; ";
+                            },
+                            PREORDER);
+
+                    return statements;
+                }
+
+                static std::string Render(SyntaxTree *tree) {
+                    static const std::map<SYNTAX_ANALYSIS_NODE_TYPE, std::string> operators = {
+                            {SYN_NODE_ADD, " + "}, {SYN_NODE_SUB, " - "}, {SYN_NODE_MUL, " * "}, {SYN_NODE_DIV, " / "}};
+
+                    if (tree->left == nullptr) return tree->get_text();
+
+                    return "(" + Render(tree->left) + operators.at(tree->type) + Render(tree->right) + ")";
+                }
+
+                /**
+                 * @return the expression after folding and simplification, with integers i, j and floats f, g
+                 */
+                static std::string Simplify(const std::string &expression) {
+                    CompilationPipeline pipeline;
+                    EXPECT_TRUE(pipeline.analyze("var i = 1; var j = 2; var f = 1.5; var g = 2.5; var r = " +
+                                                 expression + ";"))
+                            << "Expression: " << expression;
+                    auto syntax_tree = pipeline.get_syntax_tree();
+
+                    // The variables are not propagated, only the expression itself is simplified
+                    Optimiser optimiser(pipeline.get_context());
+                    SyntaxTree *value = syntax_tree->statements[syntax_tree->statement_count - 1]->right;
+                    optimiser.fold_expression(value);
+
+                    return Render(value);
+                }
+            };
+
+            TEST_F(OptimiserTests, SimplifiesIntegers) {
+                // The parser builds left associative trees, the constants are gathered across them
+                EXPECT_EQ(Simplify("i + 1 + 2"), "(i + 3)");
+                EXPECT_EQ(Simplify("2 * i * 3"), "(i * 6)");
+                EXPECT_EQ(Simplify("1 + i + 2 + j + 3"), "((i + j) + 6)");
+                EXPECT_EQ(Simplify("i - 1 + 3 - 5"), "(i - 3)");
+                EXPECT_EQ(Simplify("(i + 1) * 2"), "((i + 1) * 2)");
+
+                EXPECT_EQ(Simplify("i + 0"), "i");
+                EXPECT_EQ(Simplify("1 * i"), "i");
+                EXPECT_EQ(Simplify("i * 0 + j"), "j");
+                EXPECT_EQ(Simplify("i - 2 + 2"), "i");
+                EXPECT_EQ(Simplify("(i + j) - (i + j)"), "0");
+                EXPECT_EQ(Simplify("i - j"), "(i - j)");
+            }
+
+            TEST_F(OptimiserTests, KeepsFloatSemantics) {
+                // Reassociating would round differently, x + 0 changes -0 and x * 0 or x - x change inf and nan
+                EXPECT_EQ(Simplify("f + 1.0 + 2.0"), "((f + 1) + 2)");
+                EXPECT_EQ(Simplify("f + 0.0"), "(f + 0)");
+                EXPECT_EQ(Simplify("f * 0"), "(f * 0)");
+                EXPECT_EQ(Simplify("f - f"), "(f - f)");
+                EXPECT_EQ(Simplify("i + 1 + 2.5"), "((i + 1) + 2.5)");
+
+                EXPECT_EQ(Simplify("f * 1"), "f");
+                EXPECT_EQ(Simplify("1.0 * f"), "f");
+                EXPECT_EQ(Simplify("f / 1"), "f");
+                EXPECT_EQ(Simplify("f - 0"), "f");
+
+                // The operation turns the integer into a float
+                EXPECT_EQ(Simplify("i * 1.0"), "(i * 1)");
+                EXPECT_EQ(Simplify("i / 1"), "(i / 1)");
+            }
+
+            TEST_F(OptimiserTests, EliminatesDeadStores) {
+                // Overwritten before any read
+                EXPECT_EQ(Eliminate("var a = 1; var b = 1 + 1; b = a; a = 2;", false, 1),
+                          "var a = 1; var b = a; a = 2; ");
+
+                // Read by the store that overwrites it
+                EXPECT_EQ(Eliminate("var a = 1; a = a + 1;", false, 0), "var a = 1; a = (a + 1); ");
+
+                // Block variables end with their block, expressions have no effect
+                EXPECT_EQ(Eliminate("var a = 1; { var t = 2; var u = t * 2; a = u; } 1 + 2;", false, 1),
+                          "var a = 1; { var t = 2; var u = (t * 2); a = u; ");
+                EXPECT_EQ(Eliminate("var a = 1; { var t = a; { var u = t; } }", false, 4), "var a = 1; ");
+
+                // A store in a nested block cannot declare the variable of the outer scope
+                EXPECT_EQ(Eliminate("var a = 1; { a = 2; }", false, 0), "var a = 1; { a = 2; ");
+            }
+
+            TEST_F(OptimiserTests, EliminatesPropagatedConstants) {
+                EXPECT_EQ(Eliminate("const a = 2; const b = a * 3; var c = a + b; c = c * 2;", true, 3),
+                          "var c = 16; ");
+
+                // Only constants that are still read stay
+                EXPECT_EQ(Eliminate("const a = 2; var c = a;", false, 0), "const a = 2; var c = a; ");
+            }
+
+            TEST_F(OptimiserTests, FoldsConstants) {
+                EXPECT_EQ(Optimise("var a = 1 + 2 * 3;"), std::vector<std::string>({"7"}));
+
+                EXPECT_EQ(Optimise("var a = (1 + 2) * 3 - 4;"), std::vector<std::string>({"5"}));
+
+                EXPECT_EQ(Optimise("var a = 1 / 2;"), std::vector<std::string>({"0.5"}));
+
+                EXPECT_EQ(Optimise("var a = 0.1 + 0.2;"), std::vector<std::string>({"0.30000000000000004"}));
+            }
+
+            TEST_F(OptimiserTests, ExactIntegers) {
+                // Beyond the 24 bit mantissa of a float, and beyond the 53 bits of a double for the product
+                EXPECT_EQ(Optimise("var a = 16777217 + 2;"), std::vector<std::string>({"16777219"}));
+
+                EXPECT_EQ(Optimise("var a = 3037000499 * 3037000499 - 1;"),
+                          std::vector<std::string>({"9223372030926249000"}));
+
+                EXPECT_EQ(Optimise("var a = 9223372036854775807 + 1;"),
+                          std::vector<std::string>({"-9223372036854775808"}));
+
+                EXPECT_EQ(Optimise("var a = 9007199254740993 * 1.0;"),
+                          std::vector<std::string>({"9007199254740992"}));
+            }
+
+            TEST_F(OptimiserTests, PropagatesValues) {
+                EXPECT_EQ(Optimise("const a = 1 + 2;"
+                                   "var b = a * 3;"
+                                   "const c = b + a;"),
+                          std::vector<std::string>({"3", "9", "12"}));
+
+                // A reassignment still sees the previous value, the statements after it see the new one
+                EXPECT_EQ(Optimise("var a = 1;"
+                                   "var b = a;"
+                                   "a = a + 4;"
+                                   "var c = a + b;"),
+                          std::vector<std::string>({"1", "1", "5", "6"}));
+            }
+
+            TEST_F(OptimiserTests, PropagatesThroughBlocks) {
+                EXPECT_EQ(Optimise("var a = 1;"
+                                   "{ var a = 2; a = a + 1; var b = a; }"
+                                   "var c = a;"),
+                          std::vector<std::string>({"1", "2", "3", "3", "1"}));
+
+                EXPECT_EQ(Optimise("var a = 1;"
+                                   "{ a = a + 1; { a = a * 5; } }"
+                                   "var b = a;"),
+                          std::vector<std::string>({"1", "2", "10", "10"}));
+            }
+
+            TEST_F(OptimiserTests, LongPrograms) {
+                // Every statement depends on the previous one, a pass that rescans the program would be quadratic
+                const int count = 50000;
+                std::string input = "var v0 = 0;";
+                for (int i = 1; i < count; i++)
+                    input += "var v" + std::to_string(i) + " = v" + std::to_string(i - 1) + " + 1;";
+
+                auto assigned = Optimise(input);
+
+                ASSERT_EQ(assigned.size(), count);
+                EXPECT_EQ(assigned.back(), std::to_string(count - 1));
+            }
+        }// namespace
+    }    // namespace tests
+}// namespace soma
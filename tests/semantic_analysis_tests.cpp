@@ -7,11 +7,13 @@
 #include <gtest/gtest.h>
 #include <vector>
 #include <map>
+#include <thread>
 
 #include "../src/util/errors.h"
 #include "../src/util/types.h"
 #include "../src/lexical_analysis.h"
-#include "../src/symbol_table.cpp"
+#include "../src/compilation_context.h"
+#include "../src/symbol_table.h"
 #include "../src/semantic_analysis.cpp"
 
 namespace soma {
@@ -26,37 +28,48 @@ namespace soma {
 
                 ~SemanticAnalysisTests() override { input_stream.clear(); }
 
-                void TearDown() override {
-                    delete global_symbol_table;
-                    global_symbol_table = new SymbolTableTree();
-                }
-
                 void CheckSemantics(const std::string &input,
-                                    const std::map<std::string, SymbolTableTreeData> &expected_entries) {
+                                    const std::map<std::string, SymbolTableData> &expected_entries) {
                     input_stream = std::istringstream(input);
 
+                    CompilationContext context;
                     auto lexical_analysis = new LexicalAnalysis(&input_stream);
-                    auto syntax_analysis = new SyntaxAnalysis(lexical_analysis);
+                    auto syntax_analysis = new SyntaxAnalysis(lexical_analysis, &context);
                     auto syntax_tree = syntax_analysis->build_tree();
-                    auto semantic_analysis = new SemanticAnalysis();
+                    auto semantic_analysis = new SemanticAnalysis(&context);
                     semantic_analysis->analyze_tree(syntax_tree);
 
                     for (auto &entry: expected_entries) {
                         auto name = entry.first;
                         auto data = entry.second;
 
-                        auto token = global_symbol_table->find(&name);
+                        auto token = context.get_symbol_table()->find(
+                                context.get_interner()->find(name.data(), name.size()));
 
                         if (token == nullptr) { FAIL() << "Symbol " << name << " not found"; }
 
-                        EXPECT_EQ(data.get_type(), token->data->get_type())
+                        EXPECT_EQ(data.get_type(), token->data.get_type())
                                 << "Symbol " << name << " type mismatch. Input: " << input;
-                        EXPECT_EQ(data.get_flags(), token->data->get_flags())
+                        EXPECT_EQ(data.get_flags(), token->data.get_flags())
                                 << "Symbol " << name << " value mismatch. Input: " << input;
                     }
+                }
 
-                    delete global_symbol_table;
-                    global_symbol_table = new SymbolTableTree();
+                static void CheckErrors(const std::string &input, const std::vector<std::string> &expected_errors) {
+                    std::istringstream stream(input);
+                    CompilationContext context;
+                    LexicalAnalysis lexical_analysis(&stream);
+                    SyntaxAnalysis syntax_analysis(&lexical_analysis, &context);
+                    SemanticAnalysis semantic_analysis(&context);
+                    semantic_analysis.analyze_tree(syntax_analysis.build_tree());
+
+                    std::vector<std::string> actual_errors;
+                    for (auto &diagnostic: context.get_diagnostics()->get_diagnostics()) {
+                        actual_errors.push_back(std::to_string(diagnostic.line) + ":" +
+                                                std::to_string(diagnostic.column) + ": " + diagnostic.message);
+                    }
+
+                    EXPECT_EQ(actual_errors, expected_errors) << "Input: " << input;
                 }
             };
 
@@ -67,32 +80,30 @@ namespace soma {
             }
 
             TEST_F(SemanticAnalysisTests, VariableDeclaration) {
-                SymbolTableTreeData a{};
+                SymbolTableData a{};
                 a.set_flag(SYM_TABLE_IS_DEFINED | SYM_TABLE_IS_CONSTANT);
                 a.set_type(SYM_TABLE_TYPE_INT);
 
-                CheckSemantics("const a = 1;", {std::pair<std::string, SymbolTableTreeData>("a", a)});
+                CheckSemantics("const a = 1;", {std::pair<std::string, SymbolTableData>("a", a)});
 
                 a.unset_flag(SYM_TABLE_IS_CONSTANT);
-                CheckSemantics("var a = 1;", {std::pair<std::string, SymbolTableTreeData>("a", a)});
+                CheckSemantics("var a = 1;", {std::pair<std::string, SymbolTableData>("a", a)});
 
                 CheckSemantics("var a = 1;"
                                "a = 12;",
-                               {std::pair<std::string, SymbolTableTreeData>("a", a)});
+                               {std::pair<std::string, SymbolTableData>("a", a)});
 
-                EXPECT_DEATH(CheckSemantics("var a = 1;"
-                                            "const a = 2;",
-                                            {}),
-                             "Variable .* is already declared");
+                CheckErrors("var a = 1;"
+                            "const a = 2;",
+                            {"1:17: Variable a is already declared"});
 
-                EXPECT_DEATH(CheckSemantics("const a = 1;"
-                                            "a = 2;",
-                                            {}),
-                             "Variable .* is constant and cannot be reassigned");
+                CheckErrors("const a = 1;"
+                            "a = 2;",
+                            {"1:13: Variable a is constant and cannot be reassigned"});
             }
 
             TEST_F(SemanticAnalysisTests, ExpressionsWithVariables) {
-                SymbolTableTreeData a{}, b{}, c{};
+                SymbolTableData a{}, b{}, c{};
                 a.set_flag(SYM_TABLE_IS_DEFINED | SYM_TABLE_IS_CONSTANT);
                 a.set_type(SYM_TABLE_TYPE_INT);
                 b.set_flag(SYM_TABLE_IS_DEFINED);
@@ -103,11 +114,97 @@ namespace soma {
                 CheckSemantics("const a = 1;"
                                "var b = a * 1;"
                                "const c = a - b / 3;",
-                               {std::pair<std::string, SymbolTableTreeData>("a", a),
-                                std::pair<std::string, SymbolTableTreeData>("b", b),
-                                std::pair<std::string, SymbolTableTreeData>("c", c)});
+                               {std::pair<std::string, SymbolTableData>("a", a),
+                                std::pair<std::string, SymbolTableData>("b", b),
+                                std::pair<std::string, SymbolTableData>("c", c)});
+
+                CheckErrors("const a = 1; var b = c;", {"1:22: Variable c is used before definition"});
+            }
+
+            TEST_F(SemanticAnalysisTests, BlockScopes) {
+                SymbolTableData a{}, b{};
+                a.set_flag(SYM_TABLE_IS_DEFINED | SYM_TABLE_IS_CONSTANT);
+                a.set_type(SYM_TABLE_TYPE_INT);
+                b.set_flag(SYM_TABLE_IS_DEFINED);
+                b.set_type(SYM_TABLE_TYPE_FLOAT);
+
+                // The inner declarations shadow the outer ones and disappear with their block
+                CheckSemantics("const a = 1;"
+                               "var b = 1;"
+                               "{ var a = 2.5; b = a; { const b = a; } }",
+                               {std::pair<std::string, SymbolTableData>("a", a),
+                                std::pair<std::string, SymbolTableData>("b", b)});
+
+                CheckErrors("{ var a = 1; } var b = a;", {"1:24: Variable a is used before definition"});
+
+                CheckErrors("var a = 1; { var a = 2; var a = 3; }", {"1:29: Variable a is already declared"});
+
+                CheckErrors("const a = 1; { a = 2; }", {"1:16: Variable a is constant and cannot be reassigned"});
+
+                // Stray closing brackets do not take the declaration after them along
+                b.set_type(SYM_TABLE_TYPE_INT);
+                CheckSemantics("}}} var b = 1;", {std::pair<std::string, SymbolTableData>("b", b)});
+            }
+
+            TEST_F(SemanticAnalysisTests, ReportsAllErrors) {
+                // A failed declaration is not made, an undefined value still declares its variable
+                CheckErrors("var a = x;\n"
+                            "const b = a + y;\n"
+                            "b = 1;\n"
+                            "var a = 2;\n"
+                            "c = a;",
+                            {"1:9: Variable x is used before definition", "2:15: Variable y is used before definition",
+                             "3:1: Variable b is constant and cannot be reassigned",
+                             "4:5: Variable a is already declared", "5:1: Variable c is not declared"});
+            }
+
+            TEST_F(SemanticAnalysisTests, Slots) {
+                std::istringstream stream("var a = 1; { var a = a + 1; a = a * 2; } a = a + 3;");
+
+                CompilationContext context;
+                LexicalAnalysis lexical_analysis(&stream);
+                SyntaxAnalysis syntax_analysis(&lexical_analysis, &context);
+                auto syntax_tree = syntax_analysis.build_tree();
+                SemanticAnalysis semantic_analysis(&context);
+                semantic_analysis.analyze_tree(syntax_tree);
+
+                std::vector<SymbolSlot> slots;
+                syntax_tree->process_tree_using(
+                        [&](SyntaxTree *tree) {
+                            if (tree->type == SYN_NODE_IDENTIFIER) slots.push_back(tree->slot);
+                        },
+                        INORDER);
+
+                EXPECT_EQ(semantic_analysis.get_slot_count(), 2);
+                EXPECT_EQ(slots, std::vector<SymbolSlot>({0, 1, 0, 1, 1, 0, 0}));
+            }
+
+            TEST_F(SemanticAnalysisTests, IndependentContexts) {
+                std::vector<std::thread> threads;
+                std::vector<SYM_TABLE_DATA_TYPE> types(8, SYM_TABLE_TYPE_UNKNOWN);
+
+                for (size_t i = 0; i < types.size(); i++) {
+                    threads.emplace_back([&types, i]() {
+                        // Every thread declares the same names with its own type
+                        std::string input = i % 2 ? "var a = 1; { var b = a / 2; a = b; }" : "var a = 1; a = a + 2;";
+                        for (int j = 0; j < 200; j++) input += "{ var c = a; a = c * 2; }";
+                        std::istringstream stream(input);
+
+                        CompilationContext context;
+                        LexicalAnalysis lexical_analysis(&stream);
+                        SyntaxAnalysis syntax_analysis(&lexical_analysis, &context);
+                        SemanticAnalysis semantic_analysis(&context);
+                        semantic_analysis.analyze_tree(syntax_analysis.build_tree());
+
+                        auto token = context.get_symbol_table()->find(context.get_interner()->find("a", 1));
+                        types[i] = token->data.get_type();
+                    });
+                }
+
+                for (auto &thread: threads) thread.join();
 
-                EXPECT_DEATH(CheckSemantics("const a = 1; var b = c;", {}), "Variable .* is used before definition");
+                for (size_t i = 0; i < types.size(); i++)
+                    EXPECT_EQ(types[i], i % 2 ? SYM_TABLE_TYPE_FLOAT : SYM_TABLE_TYPE_INT);
             }
         }// namespace
     }    // namespace tests
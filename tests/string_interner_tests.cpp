@@ -0,0 +1,63 @@
+/**
+ * Tests for string interning
+ * @file: string_interner_tests.cpp
+ * @date: 17.10.2026
+ */
+
+#include <gtest/gtest.h>
+#include <string>
+
+#include "../src/string_interner.cpp"
+
+namespace soma {
+    namespace tests {
+        namespace {
+            TEST(StringInternerTests, SameTextSameId) {
+                StringInterner interner;
+
+                SymbolId a = interner.intern("abc", 3);
+                SymbolId b = interner.intern("abd", 3);
+                SymbolId c = interner.intern("abcd", 3);
+
+                EXPECT_NE(a, b);
+                EXPECT_EQ(a, c);
+                EXPECT_EQ(interner.size(), 2);
+                EXPECT_STREQ(interner.get_text(a), "abc");
+                EXPECT_EQ(interner.get_length(b), 3);
+            }
+
+            TEST(StringInternerTests, Find) {
+                StringInterner interner;
+
+                EXPECT_EQ(interner.find("a", 1), SYMBOL_ID_NONE);
+
+                SymbolId a = interner.intern("a", 1);
+
+                EXPECT_EQ(interner.find("a", 1), a);
+                EXPECT_EQ(interner.find("b", 1), SYMBOL_ID_NONE);
+                EXPECT_EQ(interner.size(), 1);
+            }
+
+            TEST(StringInternerTests, StableAcrossGrowth) {
+                StringInterner interner;
+                std::vector<const char *> texts;
+
+                for (int i = 0; i < 10000; i++) {
+                    std::string name = "v" + std::to_string(i);
+                    SymbolId id = interner.intern(name.data(), name.size());
+
+                    EXPECT_EQ(id, (SymbolId) i);
+                    texts.push_back(interner.get_text(id));
+                }
+
+                for (int i = 0; i < 10000; i++) {
+                    std::string name = "v" + std::to_string(i);
+
+                    EXPECT_EQ(interner.find(name.data(), name.size()), (SymbolId) i);
+                    EXPECT_EQ(interner.get_text((SymbolId) i), texts[i]);
+                    EXPECT_EQ(name, texts[i]);
+                }
+            }
+        }// namespace
+    }    // namespace tests
+}// namespace soma
@@ -0,0 +1,139 @@
+/**
+ * Tests for the symbol table
+ * @file: symbol_table_tests.cpp
+ * @date: 17.10.2026
+ */
+
+#include <gtest/gtest.h>
+#include <algorithm>
+#include <random>
+#include <set>
+
+#include "../src/symbol_table.cpp"
+
+namespace soma {
+    namespace tests {
+        namespace {
+            TEST(SymbolTableTests, InsertFind) {
+                SymbolTable table;
+
+                EXPECT_EQ(table.find(1), nullptr);
+
+                auto entry = table.insert(1);
+                entry->data.set_type(SYM_TABLE_TYPE_FLOAT);
+                entry->data.set_flag(SYM_TABLE_IS_DEFINED);
+
+                EXPECT_EQ(table.insert(1), entry);
+                EXPECT_EQ(table.size(), 1);
+                ASSERT_NE(table.find(1), nullptr);
+                EXPECT_EQ(table.find(1)->key, 1);
+                EXPECT_EQ(table.find(1)->data.get_type(), SYM_TABLE_TYPE_FLOAT);
+                EXPECT_EQ(table.find(1)->data.get_flags(), SYM_TABLE_IS_DEFINED);
+                EXPECT_EQ(table.find(2), nullptr);
+            }
+
+            TEST(SymbolTableTests, Remove) {
+                SymbolTable table;
+
+                table.insert(7);
+                table.remove(7);
+                table.remove(8);
+
+                EXPECT_EQ(table.find(7), nullptr);
+                EXPECT_EQ(table.size(), 0);
+                EXPECT_EQ(table.insert(7)->data.get_flags(), SYM_TABLE_NO_FLAG);
+            }
+
+            TEST(SymbolTableTests, MatchesReferenceSet) {
+                SymbolTable table;
+                std::set<SymbolId> reference;
+                std::mt19937 generator(7);
+                std::uniform_int_distribution<SymbolId> keys(0, 2000);
+
+                for (int i = 0; i < 50000; i++) {
+                    SymbolId key = keys(generator);
+
+                    if (generator() % 3 == 0) {
+                        table.remove(key);
+                        reference.erase(key);
+                    } else {
+                        table.insert(key)->data.set_type(key % 2 ? SYM_TABLE_TYPE_INT : SYM_TABLE_TYPE_FLOAT);
+                        reference.insert(key);
+                    }
+                }
+
+                EXPECT_EQ(table.size(), reference.size());
+                for (SymbolId key = 0; key <= 2000; key++) {
+                    auto entry = table.find(key);
+
+                    if (reference.count(key)) {
+                        ASSERT_NE(entry, nullptr) << "Key: " << key;
+                        EXPECT_EQ(entry->data.get_type(), key % 2 ? SYM_TABLE_TYPE_INT : SYM_TABLE_TYPE_FLOAT);
+                    } else {
+                        EXPECT_EQ(entry, nullptr) << "Key: " << key;
+                    }
+                }
+            }
+
+            TEST(ScopedSymbolTableTests, Shadowing) {
+                ScopedSymbolTable table;
+
+                table.declare(1)->data.set_type(SYM_TABLE_TYPE_INT);
+                EXPECT_EQ(table.get_depth(), 0);
+
+                table.enter_scope();
+                auto inner = table.declare(1);
+                inner->data.set_type(SYM_TABLE_TYPE_FLOAT);
+                table.declare(2);
+
+                EXPECT_EQ(table.get_depth(), 1);
+                EXPECT_EQ(table.find(1)->data.get_type(), SYM_TABLE_TYPE_FLOAT);
+                EXPECT_EQ(table.find(1)->data.get_scope_depth(), 1);
+                EXPECT_NE(table.find(2), nullptr);
+
+                table.exit_scope();
+
+                EXPECT_EQ(table.get_depth(), 0);
+                EXPECT_EQ(table.find(1)->data.get_type(), SYM_TABLE_TYPE_INT);
+                EXPECT_EQ(table.find(1)->data.get_scope_depth(), 0);
+                EXPECT_EQ(table.find(2), nullptr);
+                EXPECT_EQ(table.size(), 1);
+
+                table.exit_scope();
+                EXPECT_NE(table.find(1), nullptr);
+
+                // Removing is left to the global scope, where no scope restores the key
+                table.enter_scope();
+                table.remove(1);
+                EXPECT_NE(table.find(1), nullptr);
+                table.exit_scope();
+                table.remove(1);
+                EXPECT_EQ(table.find(1), nullptr);
+                EXPECT_EQ(table.size(), 0);
+            }
+
+            TEST(ScopedSymbolTableTests, DeepNesting) {
+                ScopedSymbolTable table;
+                const uint32_t depth = 10000;
+
+                for (uint32_t i = 0; i < depth; i++) {
+                    table.enter_scope();
+                    table.declare(i % 3)->data.set_slot(i);
+                    table.declare(100 + i)->data.set_slot(i);
+                }
+
+                EXPECT_EQ(table.get_depth(), depth);
+                EXPECT_EQ(table.find(0)->data.get_slot(), depth - 1 - (depth - 1) % 3);
+                EXPECT_EQ(table.size(), depth + 3);
+
+                for (uint32_t i = depth; i-- > 0;) {
+                    EXPECT_EQ(table.find(i % 3)->data.get_scope_depth(), i + 1);
+                    table.exit_scope();
+                    EXPECT_EQ(table.find(100 + i), nullptr);
+                }
+
+                EXPECT_EQ(table.size(), 0);
+            }
+        }// namespace
+    }    // namespace tests
+}// namespace soma
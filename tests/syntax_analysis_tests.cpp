@@ -5,7 +5,10 @@
  */
 
 #include <gtest/gtest.h>
+#include <map>
 
+#include "../src/diagnostics.cpp"
+#include "../src/compilation_context.cpp"
 #include "../src/syntax_analysis.cpp"
 
 namespace soma {
@@ -14,6 +17,7 @@ namespace soma {
             class SyntaxAnalysisTests : public ::testing::Test {
             protected:
                 std::istringstream input_stream;
+                CompilationContext context;
                 std::string actual_nodes;
                 std::string expected_nodes;
 
@@ -34,30 +38,62 @@ namespace soma {
                     input_stream = std::istringstream(input);
 
                     auto lexical_analysis = new LexicalAnalysis(&input_stream);
-                    auto syntax_analysis = new SyntaxAnalysis(lexical_analysis);
+                    auto syntax_analysis = new SyntaxAnalysis(lexical_analysis, &context);
                     auto syntax_tree = syntax_analysis->build_tree();
 
-                    syntax_tree->process_tree_using(
-                            [&](SyntaxTree *tree) { actual_nodes += std::to_string(tree->type) + " "; }, INORDER);
+                    if (syntax_tree != nullptr) {
+                        syntax_tree->process_tree_using(
+                                [&](SyntaxTree *tree) { actual_nodes += std::to_string(tree->type) + " "; }, INORDER);
+                    }
 
                     for (auto expected_node: expected) expected_nodes += std::to_string(expected_node) + " ";
 
                     EXPECT_EQ(actual_nodes, expected_nodes) << "Input: " << input;
                 }
+
+                static void CheckErrors(const std::string &input, const std::vector<std::string> &expected_errors) {
+                    std::istringstream stream(input);
+                    CompilationContext error_context;
+                    LexicalAnalysis lexical_analysis(&stream);
+                    SyntaxAnalysis syntax_analysis(&lexical_analysis, &error_context);
+                    syntax_analysis.build_tree();
+
+                    std::vector<std::string> actual_errors;
+                    for (auto &diagnostic: error_context.get_diagnostics()->get_diagnostics()) {
+                        actual_errors.push_back(std::to_string(diagnostic.line) + ":" +
+                                                std::to_string(diagnostic.column) + ": " + diagnostic.message);
+                    }
+
+                    EXPECT_EQ(actual_errors, expected_errors) << "Input: " << input;
+                }
             };
 
             TEST_F(SyntaxAnalysisTests, Empty) {
-                CheckSyntaxTree("", {});
+                CheckSyntaxTree("", {SYN_NODE_SEQUENCE});
 
-                CheckSyntaxTree("   ", {});
+                CheckSyntaxTree("   ", {SYN_NODE_SEQUENCE});
 
-                CheckSyntaxTree("   \t  \n  \t   ", {});
+                CheckSyntaxTree("   \t  \n  \t   ", {SYN_NODE_SEQUENCE});
             }
 
             TEST_F(SyntaxAnalysisTests, SingleNumbers) {
                 CheckSyntaxTree("1;", {SYN_NODE_SEQUENCE, SYN_NODE_INTEGER_LITERAL});
 
                 CheckSyntaxTree("1.2e-1;", {SYN_NODE_SEQUENCE, SYN_NODE_FLOAT_LITERAL});
+
+                CheckErrors("9223372036854775808;", {"1:1: Integer literal out of range: 9223372036854775808"});
+            }
+
+            TEST_F(SyntaxAnalysisTests, LiteralValues) {
+                std::istringstream stream("9223372036854775807; 1.2e-1; 0.1;");
+                LexicalAnalysis lexical_analysis(&stream);
+                SyntaxAnalysis syntax_analysis(&lexical_analysis, &context);
+                auto syntax_tree = syntax_analysis.build_tree();
+
+                ASSERT_EQ(syntax_tree->statement_count, 3);
+                EXPECT_EQ(syntax_tree->statements[0]->integer_value, INT64_MAX);
+                EXPECT_EQ(syntax_tree->statements[1]->float_value, 1.2e-1);
+                EXPECT_EQ(syntax_tree->statements[2]->get_text(), "0.1");
             }
 
             TEST_F(SyntaxAnalysisTests, ArithmeticExpressions) {
@@ -86,13 +122,13 @@ namespace soma {
                                  SYN_NODE_ADD, SYN_NODE_INTEGER_LITERAL, SYN_NODE_DIV, SYN_NODE_INTEGER_LITERAL,
                                  SYN_NODE_MUL, SYN_NODE_INTEGER_LITERAL});
 
-                EXPECT_DEATH(CheckSyntaxTree("1 + 2", {}), "Unexpected token: . Expected: ;");
+                CheckErrors("1 + 2", {"1:6: Unexpected token: . Expected: ;"});
 
-                EXPECT_DEATH(CheckSyntaxTree("1 +", {}), "Expected expression but found:.*");
+                CheckErrors("1 +", {"1:4: Expected expression but found: "});
 
-                EXPECT_DEATH(CheckSyntaxTree("1 + (", {}), "Expected expression but found:");
+                CheckErrors("1 + (", {"1:6: Expected expression but found: "});
 
-                EXPECT_DEATH(CheckSyntaxTree("1 + (2))", {}), "Unexpected token: ). Expected: ;");
+                CheckErrors("1 + (2))", {"1:8: Unexpected token: ). Expected: ;"});
             }
 
             TEST_F(SyntaxAnalysisTests, Assignment) {
@@ -107,24 +143,151 @@ namespace soma {
                                 "const b = a * 3;"
                                 "const c = b + a;",
                                 {SYN_NODE_SEQUENCE, SYN_NODE_IDENTIFIER, SYN_NODE_ASSIGNMENT, SYN_NODE_INTEGER_LITERAL,
-                                 SYN_NODE_ADD, SYN_NODE_INTEGER_LITERAL, SYN_NODE_SEQUENCE, SYN_NODE_IDENTIFIER,
-                                 SYN_NODE_ASSIGNMENT, SYN_NODE_IDENTIFIER, SYN_NODE_MUL, SYN_NODE_INTEGER_LITERAL,
-                                 SYN_NODE_SEQUENCE, SYN_NODE_IDENTIFIER, SYN_NODE_ASSIGNMENT, SYN_NODE_IDENTIFIER,
-                                 SYN_NODE_ADD, SYN_NODE_IDENTIFIER});
+                                 SYN_NODE_ADD, SYN_NODE_INTEGER_LITERAL, SYN_NODE_IDENTIFIER, SYN_NODE_ASSIGNMENT,
+                                 SYN_NODE_IDENTIFIER, SYN_NODE_MUL, SYN_NODE_INTEGER_LITERAL, SYN_NODE_IDENTIFIER,
+                                 SYN_NODE_ASSIGNMENT, SYN_NODE_IDENTIFIER, SYN_NODE_ADD, SYN_NODE_IDENTIFIER});
 
                 CheckSyntaxTree("const a = 1 + 2;"
                                 "a = a * 3;",
                                 {SYN_NODE_SEQUENCE, SYN_NODE_IDENTIFIER, SYN_NODE_ASSIGNMENT, SYN_NODE_INTEGER_LITERAL,
-                                 SYN_NODE_ADD, SYN_NODE_INTEGER_LITERAL, SYN_NODE_SEQUENCE, SYN_NODE_IDENTIFIER,
-                                 SYN_NODE_ASSIGNMENT, SYN_NODE_IDENTIFIER, SYN_NODE_MUL, SYN_NODE_INTEGER_LITERAL});
+                                 SYN_NODE_ADD, SYN_NODE_INTEGER_LITERAL, SYN_NODE_IDENTIFIER, SYN_NODE_ASSIGNMENT,
+                                 SYN_NODE_IDENTIFIER, SYN_NODE_MUL, SYN_NODE_INTEGER_LITERAL});
+
+                CheckErrors("const ", {"1:7: Unexpected token: . Expected: ID"});
 
-                EXPECT_DEATH(CheckSyntaxTree("const ", {}), "Unexpected token: . Expected: ID");
+                CheckErrors("const abc", {"1:10: Unexpected token: . Expected: ="});
 
-                EXPECT_DEATH(CheckSyntaxTree("const abc", {}), "Unexpected token: . Expected: =");
+                CheckErrors("const abc =", {"1:12: Expected expression but found: "});
 
-                EXPECT_DEATH(CheckSyntaxTree("const abc =", {}), "Expected expression but found: ");
+                CheckErrors("const abc = 1", {"1:14: Unexpected token: . Expected: ;"});
+            }
+
+            TEST_F(SyntaxAnalysisTests, Block) {
+                CheckSyntaxTree("{}", {SYN_NODE_SEQUENCE, SYN_NODE_BLOCK});
+
+                CheckSyntaxTree("{ var a = 1; }", {SYN_NODE_SEQUENCE, SYN_NODE_BLOCK, SYN_NODE_IDENTIFIER,
+                                                   SYN_NODE_ASSIGNMENT, SYN_NODE_INTEGER_LITERAL});
+
+                CheckSyntaxTree("{ { a = 1; } }", {SYN_NODE_SEQUENCE, SYN_NODE_BLOCK, SYN_NODE_BLOCK,
+                                                   SYN_NODE_IDENTIFIER, SYN_NODE_ASSIGNMENT, SYN_NODE_INTEGER_LITERAL});
+
+                CheckErrors("{ var a = 1;", {"1:13: Unexpected token: . Expected: }"});
 
-                EXPECT_DEATH(CheckSyntaxTree("const abc = 1", {}), "Unexpected token: . Expected: ;");
+                CheckErrors("}", {"1:1: Expected statement but found: }"});
+
+                // A closing bracket without a block is skipped on its own, the statements after it are kept
+                CheckErrors("}} var a = 1;",
+                            {"1:1: Expected statement but found: }", "1:2: Expected statement but found: }"});
+                CheckSyntaxTree("} var a = 1;", {SYN_NODE_SEQUENCE, SYN_NODE_IDENTIFIER, SYN_NODE_ASSIGNMENT,
+                                                 SYN_NODE_INTEGER_LITERAL});
+            }
+
+            TEST_F(SyntaxAnalysisTests, ErrorRecovery) {
+                CheckErrors("var a = ;\n"
+                            "var b = 1 +;\n"
+                            "var c = 2;\n"
+                            "{ d = ; e = 1 }\n"
+                            "f = 1.2e; var g = (1;",
+                            {"1:9: Expected expression but found: ;", "2:12: Expected expression but found: ;",
+                             "4:7: Expected expression but found: ;", "4:15: Unexpected token: }. Expected: ;",
+                             "5:5: Invalid float: 1.2e", "5:21: Unexpected token: ;. Expected: )"});
+
+                // Only the statements without errors are kept
+                CheckSyntaxTree("var a = ; var c = 2; { d = ; e = 1; }",
+                                {SYN_NODE_SEQUENCE, SYN_NODE_IDENTIFIER, SYN_NODE_ASSIGNMENT, SYN_NODE_INTEGER_LITERAL,
+                                 SYN_NODE_BLOCK, SYN_NODE_IDENTIFIER, SYN_NODE_ASSIGNMENT, SYN_NODE_INTEGER_LITERAL});
+                EXPECT_EQ(context.get_diagnostics()->size(), 2);
+            }
+
+            TEST_F(SyntaxAnalysisTests, DiagnosticsLimit) {
+                std::string input;
+                for (int i = 0; i < 3 * DIAGNOSTICS_DEFAULT_LIMIT; i++) input += "var = 1;";
+
+                std::istringstream stream(input);
+                LexicalAnalysis lexical_analysis(&stream);
+                SyntaxAnalysis syntax_analysis(&lexical_analysis, &context);
+
+                auto syntax_tree = syntax_analysis.build_tree();
+                EXPECT_EQ(syntax_tree->statement_count, 0);
+                EXPECT_EQ(context.get_diagnostics()->size(), DIAGNOSTICS_DEFAULT_LIMIT);
+                EXPECT_TRUE(context.get_diagnostics()->is_full());
+            }
+
+            TEST_F(SyntaxAnalysisTests, TraversalOrders) {
+                std::istringstream stream("1 * 2 + 3;");
+                LexicalAnalysis lexical_analysis(&stream);
+                SyntaxAnalysis syntax_analysis(&lexical_analysis, &context);
+                auto syntax_tree = syntax_analysis.build_tree();
+
+                std::map<TRAVERSAL_TYPE, std::vector<int>> expected = {
+                        {PREORDER, {SYN_NODE_SEQUENCE, SYN_NODE_ADD, SYN_NODE_MUL, SYN_NODE_INTEGER_LITERAL,
+                                    SYN_NODE_INTEGER_LITERAL, SYN_NODE_INTEGER_LITERAL}},
+                        {INORDER, {SYN_NODE_SEQUENCE, SYN_NODE_INTEGER_LITERAL, SYN_NODE_MUL, SYN_NODE_INTEGER_LITERAL,
+                                   SYN_NODE_ADD, SYN_NODE_INTEGER_LITERAL}},
+                        {POSTORDER, {SYN_NODE_INTEGER_LITERAL, SYN_NODE_INTEGER_LITERAL, SYN_NODE_MUL,
+                                     SYN_NODE_INTEGER_LITERAL, SYN_NODE_ADD, SYN_NODE_SEQUENCE}},
+                };
+
+                for (auto &order: expected) {
+                    std::vector<int> actual;
+                    syntax_tree->process_tree_using([&](SyntaxTree *tree) { actual.push_back(tree->type); },
+                                                    order.first);
+
+                    EXPECT_EQ(actual, order.second) << "Traversal: " << order.first;
+                }
+            }
+
+            TEST_F(SyntaxAnalysisTests, MillionStatements) {
+                const size_t count = 1000000;
+                std::string input;
+                for (size_t i = 0; i < count; i++) input += "1;";
+
+                std::istringstream stream(input);
+                LexicalAnalysis lexical_analysis(&stream);
+                SyntaxAnalysis syntax_analysis(&lexical_analysis, &context);
+                auto syntax_tree = syntax_analysis.build_tree();
+
+                size_t nodes = 0;
+                syntax_tree->process_tree_using([&](SyntaxTree *) { nodes++; }, POSTORDER);
+
+                EXPECT_EQ(syntax_tree->statement_count, count);
+                EXPECT_EQ(nodes, count + 1);
+            }
+
+            TEST_F(SyntaxAnalysisTests, DeeplyNestedBlocks) {
+                // Built directly, as the parser itself recurses into blocks
+                const uint32_t depth = 1000000;
+                Arena *arena = context.get_arena();
+
+                auto innermost = arena->allocate_array<SyntaxTree *>(2);
+                innermost[0] = arena->create<SyntaxTree>(SYN_NODE_INTEGER_LITERAL, "1");
+                innermost[1] = arena->create<SyntaxTree>(SYN_NODE_INTEGER_LITERAL, "2");
+                SyntaxTree *tree = arena->create<SyntaxTree>(SYN_NODE_BLOCK, innermost, 2);
+
+                for (uint32_t i = 1; i < depth; i++) {
+                    auto statements = arena->allocate_array<SyntaxTree *>(1);
+                    statements[0] = tree;
+                    tree = arena->create<SyntaxTree>(i + 1 == depth ? SYN_NODE_SEQUENCE : SYN_NODE_BLOCK, statements,
+                                                     1);
+                }
+
+                for (auto order: {PREORDER, INORDER, POSTORDER}) {
+                    std::vector<int> types;
+                    tree->process_tree_using(
+                            [&](SyntaxTree *node) {
+                                if (types.size() < 3 || !(node->type & SYN_NODE_BLOCK)) types.push_back(node->type);
+                            },
+                            order);
+
+                    std::vector<int> expected = {SYN_NODE_SEQUENCE, SYN_NODE_BLOCK, SYN_NODE_BLOCK,
+                                                 SYN_NODE_INTEGER_LITERAL, SYN_NODE_INTEGER_LITERAL};
+                    if (order == POSTORDER) {
+                        expected = {SYN_NODE_INTEGER_LITERAL, SYN_NODE_INTEGER_LITERAL, SYN_NODE_BLOCK,
+                                    SYN_NODE_SEQUENCE};
+                    }
+
+                    EXPECT_EQ(types, expected) << "Traversal: " << order;
+                }
             }
         }// namespace
     }    // namespace tests
@@ -0,0 +1,91 @@
+/**
+ * Tests for the work-stealing thread pool
+ * @file: thread_pool_tests.cpp
+ * @date: 17.10.2026
+ */
+
+#include <gtest/gtest.h>
+#include <atomic>
+#include <set>
+
+#include "../src/thread_pool.cpp"
+
+namespace soma {
+    namespace tests {
+        namespace {
+            TEST(ThreadPoolTests, RunsEveryTask) {
+                ThreadPool pool(4);
+                std::atomic<int> sum(0);
+
+                for (int i = 1; i <= 1000; i++) pool.submit([&sum, i]() { sum += i; });
+                pool.wait();
+
+                EXPECT_EQ(pool.get_thread_count(), 4);
+                EXPECT_EQ(sum, 500500);
+
+                // The pool stays usable after waiting
+                pool.submit([&sum]() { sum = 0; });
+                pool.wait();
+                EXPECT_EQ(sum, 0);
+            }
+
+            TEST(ThreadPoolTests, NestedTasks) {
+                ThreadPool pool(3);
+                std::atomic<int> count(0);
+
+                for (int i = 0; i < 10; i++) {
+                    pool.submit([&pool, &count]() {
+                        for (int j = 0; j < 100; j++) pool.submit([&count]() { count++; });
+                        count++;
+                    });
+                }
+                pool.wait();
+
+                EXPECT_EQ(count, 1010);
+            }
+
+            TEST(ThreadPoolTests, IdleWorkersSteal) {
+                ThreadPool pool(4);
+                std::mutex mutex;
+                std::set<std::thread::id> threads;
+                std::atomic<bool> release(false);
+
+                // All tasks are queued by one worker, the others only get them by stealing
+                pool.submit([&]() {
+                    for (int i = 0; i < 64; i++) {
+                        pool.submit([&]() {
+                            {
+                                std::lock_guard<std::mutex> lock(mutex);
+                                threads.insert(std::this_thread::get_id());
+                            }
+                            while (!release) std::this_thread::yield();
+                        });
+                    }
+
+                    while (true) {
+                        {
+                            std::lock_guard<std::mutex> lock(mutex);
+                            if (threads.size() >= 3) break;
+                        }
+                        std::this_thread::yield();
+                    }
+                    release = true;
+                });
+                pool.wait();
+
+                EXPECT_GE(threads.size(), 3);
+            }
+
+            TEST(ThreadPoolTests, DestructorFinishesTasks) {
+                std::atomic<int> count(0);
+
+                {
+                    ThreadPool pool(2);
+                    for (int i = 0; i < 100; i++) pool.submit([&count]() { count++; });
+                }
+
+                EXPECT_EQ(count, 100);
+            }
+        }// namespace
+    }    // namespace tests
+}// namespace soma
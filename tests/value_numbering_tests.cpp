@@ -0,0 +1,77 @@
+/**
+ * Tests for value numbering
+ * @file: value_numbering_tests.cpp
+ * @date: 17.10.2026
+ */
+
+#include <gtest/gtest.h>
+#include <string>
+
+#include "../src/compilation_pipeline.h"
+#include "../src/value_numbering.cpp"
+
+namespace soma {
+    namespace tests {
+        namespace {
+            class ValueNumberingTests : public ::testing::Test {
+            protected:
+                CompilationPipeline pipeline;
+                SyntaxTree *syntax_tree = nullptr;
+
+            public:
+                /**
+                 * Analyses and shares the input without optimising it, so its variables stay in the expressions
+                 * @return number of shared nodes
+                 */
+                size_t Share(const std::string &input) {
+                    EXPECT_TRUE(pipeline.analyze(input)) << "Input: " << input;
+                    syntax_tree = pipeline.get_syntax_tree();
+
+                    ValueNumbering value_numbering(pipeline.get_context());
+                    value_numbering.share();
+
+                    return value_numbering.get_shared_count();
+                }
+
+                SyntaxTree *Value(uint32_t statement) const { return syntax_tree->statements[statement]->right; }
+            };
+
+            TEST_F(ValueNumberingTests, SharesWithinExpression) {
+                EXPECT_EQ(Share("var a = 1; var b = 2; var c = (a + b) * (a + b);"), 3);
+
+                EXPECT_EQ(Value(2)->left, Value(2)->right);
+                EXPECT_EQ(Value(2)->left->type, SYN_NODE_ADD);
+            }
+
+            TEST_F(ValueNumberingTests, SharesAcrossStatements) {
+                Share("var a = 1; var b = 2; var c = a * b - 1; var d = b * a; var e = a - b; var f = b - a;");
+
+                // Multiplication commutes, subtraction does not
+                EXPECT_EQ(Value(2)->left, Value(3));
+                EXPECT_NE(Value(4), Value(5));
+                EXPECT_EQ(Value(4)->left, Value(5)->right);
+            }
+
+            TEST_F(ValueNumberingTests, ReassignmentStartsNewValue) {
+                Share("var a = 1; var b = 2; var c = a + b; a = 3; var d = a + b; { var b = 4; var e = a + b; }");
+
+                EXPECT_NE(Value(2), Value(4));
+                EXPECT_EQ(Value(2)->right, Value(4)->right);
+                EXPECT_NE(Value(2)->left, Value(4)->left);
+
+                SyntaxTree *block = syntax_tree->statements[5];
+                EXPECT_EQ(block->statements[1]->right->left, Value(4)->left);
+                EXPECT_NE(block->statements[1]->right->right, Value(4)->right);
+            }
+
+            TEST_F(ValueNumberingTests, LiteralsKeepTheirType) {
+                Share("var a = 1; var b = 1.0; var c = 1; var d = b * 1.0 + a * 1;");
+
+                EXPECT_NE(Value(0), Value(1));
+                EXPECT_EQ(Value(0), Value(2));
+                EXPECT_EQ(Value(3)->left->right, Value(1));
+                EXPECT_EQ(Value(3)->right->right, Value(0));
+            }
+        }// namespace
+    }    // namespace tests
+}// namespace soma
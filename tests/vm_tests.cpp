@@ -0,0 +1,143 @@
+/**
+ * Tests for the bytecode compiler and the virtual machine
+ * @file: vm_tests.cpp
+ * @date: 17.10.2026
+ */
+
+#include <gtest/gtest.h>
+#include <string>
+
+#include "../src/compilation_pipeline.h"
+#include "../src/evaluator.h"
+#include "../src/bytecode.cpp"
+#include "../src/vm.cpp"
+
+namespace soma {
+    namespace tests {
+        namespace {
+            class VmTests : public ::testing::Test {
+            protected:
+                BytecodeProgram program;
+                // Final values of every slot computed by the evaluator on the same tree
+                std::vector<std::string> expected;
+
+            public:
+                /**
+                 * Compiles the input, optimised when requested in the same order as the driver
+                 * @return dump of the bytecode
+                 */
+                std::string Compile(const std::string &input, bool optimise = false) {
+                    CompilationPipeline pipeline;
+                    EXPECT_TRUE(pipeline.analyze(input)) << "Input: " << input;
+
+                    if (optimise) pipeline.optimize();
+                    pipeline.share_values();
+
+                    program = pipeline.compile(pipeline.lower());
+                    EXPECT_FALSE(pipeline.get_context()->get_diagnostics()->has_errors()) << "Input: " << input;
+
+                    Evaluator evaluator(pipeline.get_context(), pipeline.get_slot_count());
+                    evaluator.run();
+
+                    expected.clear();
+                    for (SymbolSlot slot = 0; slot < pipeline.get_slot_count(); slot++)
+                        expected.push_back(evaluator.get_value(slot).get_text());
+
+                    return program.dump();
+                }
+
+                void ExpectEvaluatorValues(const VirtualMachine &machine, const std::string &input) {
+                    for (SymbolSlot slot = 0; slot < expected.size(); slot++)
+                        EXPECT_EQ(machine.get_variable(slot).get_text(), expected[slot]) << "Input: " << input;
+                }
+            };
+
+            TEST_F(VmTests, Empty) {
+                EXPECT_EQ(Compile(""), "halt\n");
+                EXPECT_EQ(program.register_count, 0);
+
+                VirtualMachine machine(&program);
+                machine.run();
+            }
+
+            TEST_F(VmTests, ConstantRegisters) {
+                // Constants live in registers after the variables, equal constants share one
+                EXPECT_EQ(Compile("var a = 1;"
+                                  "var b = a * 2 + 3;"
+                                  "b = a + 2;"),
+                          "v0 = move c2\n"
+                          "t5 = mul.i v0, c3\n"
+                          "v1 = add.i t5, c4\n"
+                          "v1 = add.i v0, c3\n"
+                          "halt\n");
+
+                ASSERT_EQ(program.constants.size(), 3);
+                EXPECT_EQ(program.constants[0].get_integer(), 1);
+                EXPECT_EQ(program.constants[1].get_integer(), 2);
+                EXPECT_EQ(program.constants[2].get_integer(), 3);
+                EXPECT_EQ(program.register_count, 6);
+            }
+
+            TEST_F(VmTests, TemporariesShareRegisters) {
+                // Only two temporaries are live at the same time, however long the expression is
+                EXPECT_EQ(Compile("var a = 2.5;"
+                                  "var b = a * 2 + a * 3 + a * 4 + a * 5;"),
+                          "v0 = move c2\n"
+                          "t7 = itof c3\n"
+                          "t7 = mul.f v0, t7\n"
+                          "t8 = itof c4\n"
+                          "t8 = mul.f v0, t8\n"
+                          "t8 = add.f t7, t8\n"
+                          "t7 = itof c5\n"
+                          "t7 = mul.f v0, t7\n"
+                          "t7 = add.f t8, t7\n"
+                          "t8 = itof c6\n"
+                          "t8 = mul.f v0, t8\n"
+                          "v1 = add.f t7, t8\n"
+                          "halt\n");
+
+                EXPECT_EQ(program.register_count, 9);
+            }
+
+            TEST_F(VmTests, MatchesEvaluator) {
+                const char *inputs[] = {
+                        "var a = 7; var b = a * 3 - 1; var c = 9223372036854775807 + 1; a = b + a;",
+                        "var a = 7 / 2; var b = 1.5 * 2; var c = 0.1 + 0.2; var d = 1 / 0;",
+                        "var a = 1; var b = a; a = a / 4; b = a + b;",
+                        "var a = 1; { var a = 10; var b = a + 1; } { a = a + 2; }",
+                        "var a = 5; var b = a * a + a * a; a = b - 1;",
+                        "const k = 4; var a = k * 2; { var t = a + k; a = t * t; } var b = a - 1.5;",
+                        "var a = 2; var b = a; a = a * 1000000007 * 1000000007; b = b + a;",
+                };
+
+                for (const char *input: inputs) {
+                    for (bool optimise: {false, true}) {
+                        Compile(input, optimise);
+
+                        VirtualMachine machine(&program);
+                        machine.run();
+                        ExpectEvaluatorValues(machine, input);
+
+                        VirtualMachine switch_machine(&program);
+                        switch_machine.run_switch();
+                        ExpectEvaluatorValues(switch_machine, input);
+                    }
+                }
+            }
+
+            TEST_F(VmTests, RunsRepeatedly) {
+                // Variables are overwritten before they are read, so every run starts from the same state
+                Compile("var a = 3; var b = a * a; a = b + a; b = a - 0.5;");
+
+                VirtualMachine machine(&program);
+                for (int i = 0; i < 3; i++) {
+                    machine.run();
+                    ExpectEvaluatorValues(machine, "");
+                }
+
+                EXPECT_EQ(machine.get_variable(0).get_text(), "12");
+                EXPECT_EQ(machine.get_variable(1).get_text(), "11.5");
+            }
+        }// namespace
+    }    // namespace tests
+}// namespace soma